@@ -0,0 +1,143 @@
+// Benchmark: Arrow::updateTransform (glm::rotate/acos por flecha) frente a
+// ArrowKernel (forma cerrada, SoA, SIMD). Uso: arrow_bench [nodos] [repeticiones]
+#include "core/Arcane.hpp"
+#include "core/ArrowKernel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Referencia en doble precisión: misma composición que updateTransform
+    // (traslación * rotación Y -> dirección * escala * Rx(-90°)) sin acos, que
+    // en float pierde precisión cuando la flecha es casi paralela al eje Y
+    void referenceTransform(const glm::vec3& origen, const glm::vec3& destino, double m[16],
+                            double radius = 0.2, double thickness = 1.0) {
+        double d[3] = {double(destino.x) - origen.x, double(destino.y) - origen.y, double(destino.z) - origen.z};
+        double dist = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        double adjusted = dist - 2.0 * radius;
+        for (int k = 0; k < 16; ++k) m[k] = (k % 5 == 0) ? 1.0 : 0.0;
+        if (dist < 1e-5 || std::abs(adjusted) < 1e-5) return;
+
+        double n[3] = {d[0] / dist, d[1] / dist, d[2] / dist};
+        double sign = adjusted < 0.0 ? -1.0 : 1.0;
+        double u[3] = {n[0] * sign, n[1] * sign, n[2] * sign};
+
+        // R = rotación que lleva Y a u (columnas R*X, R*Y, R*Z)
+        double R[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+        double s2 = u[0] * u[0] + u[2] * u[2];
+        if (s2 > 1e-12) {
+            double c = u[1], s = std::sqrt(s2);
+            double a[3] = {u[2] / s, 0.0, -u[0] / s};     // Eje Y x u normalizado
+            for (int col = 0; col < 3; ++col) {
+                for (int row = 0; row < 3; ++row) {
+                    double cross = 0.0;
+                    if (col == 0) cross = (row == 1) ? a[2] : (row == 2 ? -a[1] : 0.0);
+                    if (col == 1) cross = (row == 0) ? -a[2] : (row == 2 ? a[0] : 0.0);
+                    if (col == 2) cross = (row == 0) ? a[1] : (row == 1 ? -a[0] : 0.0);
+                    R[col][row] = (col == row ? c : 0.0) + s * cross + (1.0 - c) * a[row] * a[col];
+                }
+            }
+        }
+
+        // Columnas finales: R*X*t, -R*Z*t, R*Y*len, inicio recortado por el radio
+        double len = std::abs(adjusted);
+        for (int row = 0; row < 3; ++row) {
+            m[0 + row] = R[0][row] * thickness;
+            m[4 + row] = -R[2][row] * thickness;
+            m[8 + row] = R[1][row] * len;
+        }
+        m[12] = origen.x + n[0] * radius;
+        m[13] = origen.y + n[1] * radius;
+        m[14] = origen.z + n[2] * radius;
+    }
+
+    float relativeError(float value, double reference) {
+        return static_cast<float>(std::abs(value - reference) / std::max(1.0, std::abs(reference)));
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t numNodos = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 200000;
+    uint32_t repeticiones = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 10;
+
+    std::cout << "Generando red de " << numNodos << " nodos..." << std::endl;
+    Arcane arcane(numNodos, 2);
+
+    // ----- Flechas y extremos SoA a partir de la red -----
+    std::vector<Arrow> arrows;
+    arrows.reserve(arcane.getNumArrows());
+    for (const Node& node : arcane.getNodes()) {
+        for (const Node* target : node._output) {
+            Arrow arrow;
+            arrow._origen = &node;
+            arrow._destino = target;
+            arrows.push_back(arrow);
+        }
+    }
+
+    const uint32_t count = static_cast<uint32_t>(arrows.size());
+    std::vector<float> ox(count), oy(count), oz(count), dx(count), dy(count), dz(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ox[i] = arrows[i]._origen->_posicion.x; oy[i] = arrows[i]._origen->_posicion.y; oz[i] = arrows[i]._origen->_posicion.z;
+        dx[i] = arrows[i]._destino->_posicion.x; dy[i] = arrows[i]._destino->_posicion.y; dz[i] = arrows[i]._destino->_posicion.z;
+    }
+    ArrowKernel::Endpoints endpoints{ox.data(), oy.data(), oz.data(), dx.data(), dy.data(), dz.data()};
+    std::vector<glm::mat4> kernelOut(count);
+
+    // ----- Antes: una llamada por flecha -----
+    auto start = Clock::now();
+    for (uint32_t r = 0; r < repeticiones; ++r) {
+        for (Arrow& arrow : arrows) {
+            arrow.updateTransform();
+        }
+    }
+    double before = secondsSince(start);
+
+    // ----- Después: kernel escalar en forma cerrada -----
+    start = Clock::now();
+    for (uint32_t r = 0; r < repeticiones; ++r) {
+        ArrowKernel::computeTransformsScalar(endpoints, count, kernelOut.data());
+    }
+    double scalar = secondsSince(start);
+
+    // ----- Después: kernel SIMD -----
+    start = Clock::now();
+    for (uint32_t r = 0; r < repeticiones; ++r) {
+        ArrowKernel::computeTransforms(endpoints, count, kernelOut.data());
+    }
+    double simd = secondsSince(start);
+
+    // ----- Error relativo máximo frente a la referencia en doble y a updateTransform -----
+    float maxError = 0.0f, maxLegacyError = 0.0f;
+    double reference[16];
+    for (uint32_t i = 0; i < count; ++i) {
+        referenceTransform(arrows[i]._origen->_posicion, arrows[i]._destino->_posicion, reference);
+        for (int c = 0; c < 4; ++c) {
+            for (int f = 0; f < 4; ++f) {
+                maxError = std::max(maxError, relativeError(kernelOut[i][c][f], reference[c * 4 + f]));
+                maxLegacyError = std::max(maxLegacyError, relativeError(arrows[i]._transform[c][f], reference[c * 4 + f]));
+            }
+        }
+    }
+
+    const double total = static_cast<double>(count) * repeticiones;
+    std::cout << "Flechas: " << count << " x " << repeticiones << " repeticiones\n"
+              << "updateTransform:          " << total / before / 1e6 << " M flechas/s\n"
+              << "ArrowKernel (escalar):    " << total / scalar / 1e6 << " M flechas/s\n"
+              << "ArrowKernel (" << ArrowKernel::instructionSet() << "):     "
+              << total / simd / 1e6 << " M flechas/s (x" << before / simd << ")\n"
+              << "Error relativo máximo (ArrowKernel):     " << maxError << "\n"
+              << "Error relativo máximo (updateTransform): " << maxLegacyError << std::endl;
+
+    return maxError < 1e-3f ? 0 : 1;
+}
@@ -2,7 +2,12 @@
 #include "Node.hpp"
 #include "Arrow.hpp"
 #include "DynamicArray.hpp"
+#include "LandmarkOracle.hpp"
+#include "BitSet.hpp"
+#include "DirtyRange.hpp"
+#include "PathCache.hpp"
 
+#include <atomic>
 #include <random>
 #include <cstdint>
 #include <memory>
@@ -10,13 +15,122 @@
 #include <glm/glm.hpp>           // Para glm::vec3, glm::mat4
 #include <glm/gtc/constants.hpp> // Para constantes matemáticas
 
+// Algoritmo usado por findPath
+enum class PathMode : uint8_t {
+    BFS,        // Búsqueda en anchura
+    ALT         // A* con heurística de landmarks (cae a BFS si no hay landmarks)
+};
+
+// Conexiones que sigue la expansión de vecindad
+enum class NeighborDirection : uint8_t {
+    Output,     // Siguiendo _output (sucesores)
+    Input,      // Siguiendo _input (predecesores)
+    Both
+};
+
+// Resultado de Arcane::neighborhood: ids de nodos e índices de flechas
+// (las flechas cuyos dos extremos quedan dentro del conjunto)
+struct Neighborhood {
+    DynamicArray<uint32_t> nodes;
+    DynamicArray<uint32_t> arrows;
+};
+
+// Extremos de una flecha tal como los consume el renderer en modo GPU
+// (el shader construye la matriz a partir de ellos)
+struct ArrowEndpoints {
+    glm::vec3 origen;
+    glm::vec3 destino;
+};
+static_assert(sizeof(ArrowEndpoints) == 24, "ArrowEndpoints debe ocupar 24 bytes");
+
+// Estilo empaquetado de una instancia para el modo paleta del renderer:
+// índice en Arcane::getPalette() en los bits 0-15 y banderas en el resto.
+// Sustituye al color vec3 (4 bytes en vez de 12).
+namespace InstanceStyle {
+    inline constexpr uint32_t INDEX_MASK = 0xFFFFu;
+    inline constexpr uint32_t HIGHLIGHTED = 1u << 16;      // Color de resaltado (ruta)
+}
+
+// Datos por instancia que el renderer sube a la GPU
+enum class InstanceData : uint8_t {
+    NodePositions,
+    NodeColors,
+    ArrowTransforms,
+    ArrowColors,
+    ArrowEndpoints,
+    NodeStyles,
+    ArrowStyles,
+    Count
+};
+
+// Estado de cambios de un buffer de instancias. `version` cambia con cada
+// modificación; `dirty` acumula lo modificado desde `base`. Quien subió el
+// buffer en la versión v:
+//   v == version -> no hay nada que subir
+//   v >= base    -> basta con subir `dirty`
+//   v <  base    -> hay que subirlo entero
+struct InstanceVersion {
+    uint64_t version = 0;
+    uint64_t base = 0;
+    DirtyRange dirty;
+};
+
+// Hilos: la red se comparte entre el hilo de simulación/UI y el de render
+// (RenderThread), sin cerrojos. Las conexiones, niveles, landmarks y la caché
+// de rutas son del hilo de UI (se fijan al generar la red). El de render es el
+// único que escribe, desde RenderThread::apply:
+//   - posiciones: Node::_posicion, Arrow::_transform, _extremos, _movidos
+//     (moveNodes, setArrowTransformsEnabled)
+//   - colores: Node::_color, Arrow::_color, _resaltadas, _colorResaltado,
+//     _paleta, _estilosNodos, _estilosFlechas (applyNodeMetric,
+//     resetNodeColors, highlightPath, clearHighlight)
+//   - _calcularTransformaciones, _transformacionesPendientes y _instancias
+// El hilo de UI no lee nada de esto, salvo las posiciones antes del primer
+// moveNodes (ForceLayout::reset, Octree::update); layoutApplied() lo comprueba.
 class Arcane {
 private:
     // ----- Atributos -----
     DynamicArray<Node> _nodos;
     DynamicArray<Arrow> _flechas;
+    DynamicArray<uint32_t> _primeraFlecha;      // Flechas agrupadas por origen: [id] -> primer índice
+
+    // Extremos de las flechas en SoA para el kernel por lotes (ArrowKernel)
+    struct ArrowEndpointsSoA {
+        DynamicArray<float> ox, oy, oz;
+        DynamicArray<float> dx, dy, dz;
+    };
+    ArrowEndpointsSoA _extremos;
+    bool _calcularTransformaciones = true;      // false: las matrices las construye la GPU
+    bool _transformacionesPendientes = false;
+    DynamicArray<uint8_t> _movidos;             // Espacio de trabajo de moveNodes: nodos movidos por id
+    std::atomic<bool> _layoutAplicado{false};   // moveNodes ya movió la red: las posiciones son del render
     uint32_t _niveles = 0;
     std::mt19937 _gen;
+    LandmarkOracle _landmarks;
+
+    // Espacio de trabajo reutilizado por neighborhood()
+    struct NeighborhoodWorkspace {
+        BitSet visited;
+        BitSet frontier;
+        BitSet next;
+    };
+    mutable NeighborhoodWorkspace _vecindad;
+
+    // Estado del resaltado: flechas recoloreadas por el último highlightPath
+    DynamicArray<uint32_t> _resaltadas;
+    glm::vec3 _colorResaltado = glm::vec3(1.0f);
+
+    // Modo paleta: colores por nivel (o tramos de la métrica) y estilo por instancia
+    DynamicArray<glm::vec3> _paleta;
+    DynamicArray<uint32_t> _estilosNodos;
+    DynamicArray<uint32_t> _estilosFlechas;
+
+    // Versión de la red (conexiones) y caché de rutas ligada a ella
+    uint64_t _version = 0;
+    mutable PathCache _rutas;
+
+    // Versiones y rangos sucios de los datos de instancia
+    InstanceVersion _instancias[static_cast<uint32_t>(InstanceData::Count)];
 
 
 public:
@@ -38,17 +152,83 @@ public:
     uint32_t getNumLevels() const noexcept { return _niveles + 1; }
     uint32_t getNumNodes() const noexcept { return _nodos.size(); }
     uint32_t getNumArrows() const noexcept { return _flechas.size(); }
+    const DynamicArray<Node>& getNodes() const noexcept { return _nodos; }
+    const DynamicArray<Arrow>& getArrows() const noexcept { return _flechas; }
+    uint64_t getVersion() const noexcept { return _version; }
+    const PathCache::Stats& getPathCacheStats() const noexcept { return _rutas.stats(); }
 
     // Algoritmos
-    DynamicArray<const Node*> findPath(uint32_t idOrigen, uint32_t idDestino) const;
-    DynamicArray<glm::vec3> highlightPath(const DynamicArray<const Node*>& path, 
-                                            glm::vec3 highlightColor = glm::vec3(1.0f));
+    DynamicArray<const Node*> findPath(uint32_t idOrigen, uint32_t idDestino,
+                                       PathMode mode = PathMode::BFS) const;
+    DirtyRange highlightPath(const DynamicArray<const Node*>& path, 
+                             glm::vec3 highlightColor = glm::vec3(1.0f));
+    DirtyRange clearHighlight();
+    int32_t findArrow(uint32_t idOrigen, uint32_t idDestino) const noexcept;
+
+    Neighborhood neighborhood(uint32_t id, uint32_t hops,
+                              NeighborDirection direction = NeighborDirection::Both) const;
+
+    // Oráculo de distancias (landmarks)
+    void buildLandmarks(uint32_t count, 
+                        LandmarkOracle::Strategy strategy = LandmarkOracle::Strategy::HighDegree);
+    LandmarkOracle::Bounds distanceBounds(uint32_t idOrigen, uint32_t idDestino) const noexcept {
+        return _landmarks.bounds(idOrigen, idDestino);
+    }
+    const LandmarkOracle& getLandmarks() const noexcept { return _landmarks; }
+
+    // Coloreado por métricas (p.ej. centralidad); valores por id de nodo
+    void applyNodeMetric(const DynamicArray<float>& values);
+    void resetNodeColors();
+
+    // Paleta de los estilos: un color por nivel (o 64 tramos del gradiente de
+    // la métrica). Las flechas usan el color de su origen por ARROW_SHADE.
+    static constexpr uint32_t PALETTE_SIZE = 64;
+    static constexpr float ARROW_SHADE = 0.7f;
+    const DynamicArray<glm::vec3>& getPalette() const noexcept { return _paleta; }
+    glm::vec3 getHighlightColor() const noexcept { return _colorResaltado; }
 
     // Datos para renderizado
     DynamicArray<glm::vec3> getNodePositions() const;
     DynamicArray<glm::vec3> getNodeColors() const;
     DynamicArray<glm::mat4> getArrowTransforms() const;
     DynamicArray<glm::vec3> getArrowColors() const;
+    DynamicArray<ArrowEndpoints> getArrowEndpoints() const;
+
+    // Escritura directa de un rango [first, first + count) en memoria del llamador
+    // (sin copias intermedias; p.ej. el buffer de subida del renderer)
+    void writeNodePositions(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept;
+    void writeNodeColors(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept;
+    void writeArrowTransforms(uint32_t first, uint32_t count, glm::mat4* dst) const noexcept;
+    void writeArrowColors(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept;
+    void writeArrowEndpoints(uint32_t first, uint32_t count, ArrowEndpoints* dst) const noexcept;
+    void writeNodeStyles(uint32_t first, uint32_t count, uint32_t* dst) const noexcept;
+    void writeArrowStyles(uint32_t first, uint32_t count, uint32_t* dst) const noexcept;
+
+    // Igual, pero de una lista de ids/índices (p.ej. las instancias visibles)
+    void gatherNodePositions(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept;
+    void gatherNodeColors(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept;
+    void gatherArrowTransforms(const uint32_t* ids, uint32_t count, glm::mat4* dst) const noexcept;
+    void gatherArrowColors(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept;
+    void gatherArrowEndpoints(const uint32_t* ids, uint32_t count, ArrowEndpoints* dst) const noexcept;
+    void gatherNodeStyles(const uint32_t* ids, uint32_t count, uint32_t* dst) const noexcept;
+    void gatherArrowStyles(const uint32_t* ids, uint32_t count, uint32_t* dst) const noexcept;
+
+    const InstanceVersion& getInstanceVersion(InstanceData data) const noexcept {
+        return _instancias[static_cast<uint32_t>(data)];
+    }
+
+    // Mueve los nodos a `positions` (una por id) y recalcula solo las flechas
+    // que tocan un nodo movido; marca sucios sus rangos. Devuelve cuántos se
+    // movieron. Lo usa el layout de fuerzas (ForceLayout)
+    uint32_t moveNodes(const glm::vec3* positions);
+    // true desde el primer moveNodes; a partir de ahí solo el hilo de render
+    // puede leer las posiciones de la red
+    bool layoutApplied() const noexcept { return _layoutAplicado.load(std::memory_order_acquire); }
+
+    // Con false se deja de calcular Arrow::_transform en CPU (el renderer usa
+    // getArrowEndpoints); al reactivarlo se recalculan las pendientes
+    void setArrowTransformsEnabled(bool enabled);
+    bool areArrowTransformsEnabled() const noexcept { return _calcularTransformaciones; }
     
 private:
     
@@ -61,5 +241,17 @@ private:
     void assignLevelColors();
     void generateArrows();
     void assignArrowColors();
+    glm::vec3 baseArrowColor(const Arrow& arrow) const noexcept;
+    DirtyRange restoreHighlighted();
     void updateAllArrows();
+    void reserveArrowEndpoints();
+    void computeArrowTransforms(uint32_t begin, uint32_t end) noexcept;
+    void buildShortestPathTree(uint32_t idOrigen, DynamicArray<int32_t>& parent) const;
+    DynamicArray<uint32_t> findPathALT(uint32_t idOrigen, uint32_t idDestino) const;
+    DynamicArray<uint32_t> buildPath(const DynamicArray<int32_t>& parent, uint32_t idDestino) const;
+    DynamicArray<const Node*> toNodePath(const DynamicArray<uint32_t>& ids) const;
+    void markDirty(InstanceData data, DirtyRange range);
+    void markDirty(InstanceData data);         // Buffer completo
+    void resetInstanceVersions();
+    static uint64_t nextVersion() noexcept;
 };
\ No newline at end of file
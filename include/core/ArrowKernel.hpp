@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>                  // Para glm::mat4
+
+// Cálculo por lotes de las matrices de las flechas a partir de sus extremos en
+// formato SoA (un arreglo por componente). Produce el mismo resultado que
+// Arrow::updateTransform (translate * rotate * scale * baseRotation) pero en
+// forma cerrada: la rotación de arco mínimo Y -> dirección se construye con
+// Rodrigues sin acos/sin/cos, y las cuatro matrices se componen a mano.
+// Se vectoriza con AVX2 u SSE según las opciones de compilación, con una
+// versión escalar para el resto y para otras arquitecturas.
+class ArrowKernel {
+public:
+    struct Endpoints {
+        const float* ox = nullptr;      // Origen
+        const float* oy = nullptr;
+        const float* oz = nullptr;
+        const float* dx = nullptr;      // Destino
+        const float* dy = nullptr;
+        const float* dz = nullptr;
+    };
+
+    // Escribe count matrices en out, separadas por outStride bytes
+    // (sizeof(glm::mat4) para un arreglo contiguo, sizeof(Arrow) para escribir
+    // directamente en Arrow::_transform)
+    static void computeTransforms(const Endpoints& endpoints, uint32_t count,
+                                  glm::mat4* out, size_t outStride = sizeof(glm::mat4),
+                                  float sphereRadius = 0.2f, float thickness = 1.0f) noexcept;
+
+    // Versión escalar (referencia y cola de los lotes SIMD)
+    static void computeTransformsScalar(const Endpoints& endpoints, uint32_t count,
+                                        glm::mat4* out, size_t outStride = sizeof(glm::mat4),
+                                        float sphereRadius = 0.2f, float thickness = 1.0f) noexcept;
+
+    // Conjunto de instrucciones con el que se compiló el kernel ("AVX2", "SSE2", "Escalar")
+    [[nodiscard]] static const char* instructionSet() noexcept;
+    [[nodiscard]] static uint32_t laneWidth() noexcept;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "DynamicArray.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+// Conjunto de bits de tamaño dinámico (una palabra de 64 bits por cada 64 ids).
+// Pensado para fronteras de BFS: marcar/consultar en O(1) y recorrer los bits
+// activos palabra a palabra saltando las vacías.
+class BitSet {
+private:
+    // ----- Atributos -----
+    DynamicArray<uint64_t> _words;
+    uint32_t _bits = 0;
+
+public:
+    // ----- Constructores -----
+    BitSet() = default;
+    explicit BitSet(uint32_t bits) { resize(bits); }
+
+    // ----- Metodos -----
+    void resize(uint32_t bits) {                // Ajusta el tamaño y limpia todos los bits
+        _bits = bits;
+        _words.assign((bits + 63) / 64, 0);
+    }
+
+    void clear() noexcept {                     // Pone todos los bits a cero, conserva el tamaño
+        uint64_t* words = _words.data();
+        for (uint32_t i = 0; i < _words.size(); ++i) {
+            words[i] = 0;
+        }
+    }
+
+    uint32_t size() const noexcept { return _bits; }
+
+    bool test(uint32_t i) const noexcept { return (_words.data()[i >> 6] >> (i & 63)) & 1u; }
+    void set(uint32_t i) noexcept { _words.data()[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(uint32_t i) noexcept { _words.data()[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+    // Marca el bit y devuelve si antes estaba a cero
+    bool testAndSet(uint32_t i) noexcept {
+        uint64_t& word = _words.data()[i >> 6];
+        const uint64_t mask = uint64_t(1) << (i & 63);
+        const bool wasClear = (word & mask) == 0;
+        word |= mask;
+        return wasClear;
+    }
+
+    bool any() const noexcept {
+        for (uint64_t word : _words) {
+            if (word) return true;
+        }
+        return false;
+    }
+
+    uint32_t count() const noexcept {
+        uint32_t total = 0;
+        for (uint64_t word : _words) {
+            total += static_cast<uint32_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    void swap(BitSet& other) noexcept {
+        std::swap(_words, other._words);
+        std::swap(_bits, other._bits);
+    }
+
+    // Llama fn(i) para cada bit activo, en orden creciente
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        const uint64_t* words = _words.data();
+        for (uint32_t w = 0; w < _words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word) {
+                fn((w << 6) + static_cast<uint32_t>(std::countr_zero(word)));
+                word &= word - 1;
+            }
+        }
+    }
+};
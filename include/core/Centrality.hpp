@@ -0,0 +1,26 @@
+#pragma once
+#include "DynamicArray.hpp"
+
+#include <cstdint>
+
+class Arcane;
+
+// Métricas de centralidad por nodo para detectar hubs.
+// `samples == 0` calcula la métrica exacta (BFS desde todos los nodos); con
+// `samples > 0` se usan k pivotes aleatorios y el resultado se reescala por N/k.
+// Los BFS se reparten entre los hilos del ThreadPool con acumuladores por hilo.
+class Centrality {
+public:
+    // Intermediación de Brandes (grafo dirigido, sin pesos)
+    [[nodiscard]] static DynamicArray<float> betweenness(const Arcane& arcane,
+                                                         uint32_t samples = 0,
+                                                         uint32_t seed = 42);
+
+    // Cercanía armónica: H(v) = sum 1 / d(v, u), normalizada por N - 1
+    [[nodiscard]] static DynamicArray<float> closeness(const Arcane& arcane,
+                                                       uint32_t samples = 0,
+                                                       uint32_t seed = 42);
+
+    // Ids de los k nodos con mayor valor, en orden descendente
+    [[nodiscard]] static DynamicArray<uint32_t> topNodes(const DynamicArray<float>& values, uint32_t k);
+};
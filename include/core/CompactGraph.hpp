@@ -0,0 +1,30 @@
+#pragma once
+#include "Node.hpp"
+#include "DynamicArray.hpp"
+
+#include <cstdint>
+
+// Vista CSR (compressed sparse row) de las conexiones de la red.
+// Los vecinos de cada nodo quedan contiguos y se indexan por id, de modo que
+// los recorridos masivos (BFS desde muchos orígenes) no persiguen punteros Node*.
+class CompactGraph {
+public:
+    // ----- Atributos -----
+    DynamicArray<uint32_t> _outOffsets;     // N + 1 entradas
+    DynamicArray<uint32_t> _outTargets;
+    DynamicArray<uint32_t> _inOffsets;      // N + 1 entradas
+    DynamicArray<uint32_t> _inTargets;
+
+    // ----- Constructores -----
+    CompactGraph() = default;
+    explicit CompactGraph(const DynamicArray<Node>& nodos);
+
+    // ----- Metodos -----
+    uint32_t numNodes() const noexcept { return _outOffsets.empty() ? 0 : _outOffsets.size() - 1; }
+    uint32_t numEdges() const noexcept { return _outTargets.size(); }
+
+    const uint32_t* outBegin(uint32_t id) const noexcept { return _outTargets.data() + _outOffsets.data()[id]; }
+    const uint32_t* outEnd(uint32_t id) const noexcept { return _outTargets.data() + _outOffsets.data()[id + 1]; }
+    const uint32_t* inBegin(uint32_t id) const noexcept { return _inTargets.data() + _inOffsets.data()[id]; }
+    const uint32_t* inEnd(uint32_t id) const noexcept { return _inTargets.data() + _inOffsets.data()[id + 1]; }
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+// Rango semiabierto [begin, end) de instancias modificadas, para subir a la GPU
+// solo la parte de un buffer que cambió
+struct DirtyRange {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+
+    bool empty() const noexcept { return begin >= end; }
+    uint32_t size() const noexcept { return empty() ? 0 : end - begin; }
+
+    void add(uint32_t index) noexcept { merge({index, index + 1}); }
+
+    void merge(const DirtyRange& other) noexcept {
+        if (other.empty()) return;
+        if (empty()) {
+            *this = other;
+            return;
+        }
+        begin = std::min(begin, other.begin);
+        end = std::max(end, other.end);
+    }
+};
@@ -130,6 +130,14 @@ public:
         _size = 0;
     }
 
+    void assign(uint32_t count, const T& value){    // Rellena la lista con `count` copias del valor
+        reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            _data[i] = value;
+        }
+        _size = count;
+    }
+
     void push_back(const T& value){         // Ingresa el valor al final de la lista
         if(_size >= _capacity){
             reserve(_capacity == 0 ? 4: _capacity * 2);
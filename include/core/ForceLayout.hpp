@@ -0,0 +1,95 @@
+#pragma once
+#include "CompactGraph.hpp"
+#include "Octree.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Arcane;
+
+// Layout dirigido por fuerzas (Fruchterman-Reingold) como alternativa a las
+// capas de Fibonacci. La repulsión entre todos los nodos se aproxima con
+// Barnes-Hut sobre un Octree: una celda lejana (tamaño < theta * distancia)
+// actúa como una masa en su centroide, de modo que cada iteración es
+// O(N log N). Los resortes siguen las conexiones (CSR de salida y entrada) y
+// una gravedad suave mantiene la red centrada.
+// Cada iteración recorre los nodos en orden Morton, por bloques y en
+// paralelo; cada bloque se dimensiona con el coste por nodo medido para que
+// quepa en lo que queda del presupuesto, y run() sigue donde lo dejó en la
+// llamada siguiente, así que una iteración puede repartirse entre varios
+// frames. Las posiciones solo cambian al cerrar una iteración (version()
+// aumenta); los desplazamientos se limitan por una temperatura que se enfría
+// hasta converged(), y a partir de ahí no se mueve nada.
+// Las posiciones son propias: la red no se toca aquí. Quien las consume las
+// aplica con Arcane::moveNodes.
+class ForceLayout {
+public:
+    struct Parameters {
+        float edgeLength = 2.0f;                // Longitud natural de los resortes (K)
+        float theta = 0.8f;                     // Criterio de apertura de Barnes-Hut
+        float gravity = 0.05f;                  // Atracción hacia el origen
+        float initialTemperature = 10.0f;       // Desplazamiento máximo inicial, en K
+        float cooling = 0.96f;                  // Factor por iteración
+        float minTemperature = 0.01f;           // En K; por debajo se da por convergido
+    };
+
+    static constexpr double FRAME_BUDGET_MS = 4.0;      // Rebanada por frame por defecto
+    static constexpr uint32_t MIN_CHUNK_NODES = 1024;   // Bloque mínimo entre comprobaciones del presupuesto
+
+    // `radius` es el de los puntos del índice (el de picking de index())
+    explicit ForceLayout(float radius = 0.0f);
+    ForceLayout(float radius, const Parameters& parameters);
+
+    // Toma las posiciones y conexiones de la red como punto de partida; solo
+    // antes de que el render le aplique un layout (Arcane::layoutApplied)
+    void reset(const Arcane& arcane);
+    // Vuelve a las posiciones de partida y recalienta el layout
+    void restore();
+
+    // Avanza el layout durante `budgetMilliseconds` (como mínimo un bloque).
+    // Devuelve las iteraciones completadas; con > 0, positions() cambió
+    uint32_t run(double budgetMilliseconds = FRAME_BUDGET_MS);
+
+    [[nodiscard]] const glm::vec3* positions() const noexcept { return _positions.data(); }
+    [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(_positions.size()); }
+    [[nodiscard]] uint64_t version() const noexcept { return _version; }
+    [[nodiscard]] uint32_t iteration() const noexcept { return _iteration; }
+    [[nodiscard]] float temperature() const noexcept { return _temperature; }
+    [[nodiscard]] bool converged() const noexcept;
+
+    // Índice de las posiciones actuales (sirve también para picking)
+    [[nodiscard]] const Octree& index() const noexcept { return _tree; }
+    [[nodiscard]] const Parameters& parameters() const noexcept { return _parameters; }
+
+    void clear() noexcept;
+
+private:
+    // Lista de interacciones de un nodo en SoA, rellenada hasta el ancho SIMD
+    struct Interactions {
+        std::vector<float> x, y, z, mass;
+        uint32_t count = 0;
+        void add(const glm::vec3& p, float m);
+        void pad(uint32_t width);
+    };
+
+    void computeForces(uint32_t begin, uint32_t end);   // Rango en orden Morton
+    void gather(uint32_t id, Interactions& list) const;
+    void integrate();
+    void syncIndex();
+
+    Parameters _parameters;
+    Octree _tree;
+    CompactGraph _graph;
+    std::vector<glm::vec3> _initial;
+    std::vector<glm::vec3> _positions;
+    std::vector<glm::vec3> _forces;
+    std::vector<Interactions> _workspaces;              // Una por hilo del pool
+
+    float _temperature = 0.0f;
+    uint32_t _cursor = 0;                               // Siguiente nodo (orden Morton) de la iteración en curso
+    double _nodeMilliseconds = 0.0;                     // Coste medido por nodo, para dimensionar los bloques
+    uint32_t _iteration = 0;
+    uint64_t _version = 0;
+};
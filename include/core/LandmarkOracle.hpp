@@ -0,0 +1,53 @@
+#pragma once
+#include "Node.hpp"
+#include "DynamicArray.hpp"
+
+#include <cstdint>
+
+// Oráculo de distancias en saltos basado en landmarks.
+// Precalcula d(L, v) y d(v, L) para K landmarks con BFS hacia adelante y hacia
+// atrás, y responde cotas inferior/superior de d(a, b) en O(K) por la
+// desigualdad triangular. La cota inferior sirve también como heurística ALT.
+class LandmarkOracle {
+public:
+    enum class Strategy : uint8_t {
+        HighDegree,     // Los K nodos con más conexiones
+        PerLevel        // El nodo de mayor grado de cada nivel (hasta K)
+    };
+
+    static constexpr uint16_t INF = 0xFFFF;
+    static constexpr uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+    struct Bounds {
+        uint32_t lower = 0;
+        uint32_t upper = UNREACHABLE;   // UNREACHABLE si ningún landmark acota
+
+        bool unreachable() const noexcept { return lower == UNREACHABLE; }
+        bool exact() const noexcept { return lower == upper; }
+    };
+
+    // ----- Constructores -----
+    LandmarkOracle() = default;
+    LandmarkOracle(LandmarkOracle&& other) noexcept = default;
+    LandmarkOracle& operator=(LandmarkOracle&& other) noexcept = default;
+
+    // ----- Metodos -----
+    void build(const DynamicArray<Node>& nodos, uint32_t count, Strategy strategy = Strategy::HighDegree);
+    void clear() noexcept;
+
+    bool empty() const noexcept { return _k == 0; }
+    uint32_t size() const noexcept { return _k; }
+    const DynamicArray<uint32_t>& landmarks() const noexcept { return _landmarks; }
+
+    [[nodiscard]] Bounds bounds(uint32_t a, uint32_t b) const noexcept;
+    [[nodiscard]] uint32_t lowerBound(uint32_t a, uint32_t b) const noexcept;
+
+private:
+    uint32_t _numNodes = 0;
+    uint32_t _k = 0;
+    DynamicArray<uint32_t> _landmarks;
+
+    // Distancias por nodo contiguas: [v * K + l]. Una consulta lee dos bloques de K
+    DynamicArray<uint16_t> _forward;    // d(L, v)
+    DynamicArray<uint16_t> _backward;   // d(v, L)
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include "DynamicArray.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Arcane;
+
+// Índice espacial de puntos (p.ej. las posiciones de los nodos) para picking,
+// consultas por radio o caja, culling y vecinos del layout.
+// Los puntos se ordenan por código Morton y el árbol se construye nivel a
+// nivel: cada celda con más de LEAF_SIZE puntos se divide en los octantes
+// ocupados, que quedan contiguos en _cells. Construcción (códigos, ordenación
+// y cada nivel) en paralelo con el pool de hilos.
+// Si los puntos se mueven sin cambiar su número, commit() reajusta las cajas
+// de abajo arriba sin reordenar (las celdas pasan a poder solaparse, como en
+// un BVH); con un rango de ids solo se rehacen las ramas que los contienen.
+// reorder() fuerza un nuevo orden en el siguiente commit cuando el
+// desplazamiento acumulado degrada las consultas.
+class Octree {
+public:
+    static constexpr uint32_t LEAF_SIZE = 16;
+    static constexpr uint32_t MAX_DEPTH = 10;          // 10 bits por eje en el código Morton
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    enum class Overlap : uint8_t { Outside, Inside, Intersects };
+
+    struct Cell {
+        glm::vec3 lo{0.0f};                     // Caja de los puntos, ampliada por el radio
+        glm::vec3 hi{0.0f};
+        glm::vec3 centroid{0.0f};               // Media de los puntos (centro de masas)
+        uint32_t count = 0;
+        uint32_t begin = 0;                     // Rango [begin, begin + count) en order()
+        uint32_t firstChild = 0;                // Hijos contiguos; childCount == 0 es hoja
+        uint8_t childCount = 0;
+        uint8_t depth = 0;
+    };
+
+    // Formas de consulta: overlap() clasifica una caja y contains() un punto
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+        [[nodiscard]] Overlap overlap(const glm::vec3& lo, const glm::vec3& hi) const noexcept;
+        [[nodiscard]] bool contains(const glm::vec3& p) const noexcept;
+    };
+    struct Box {
+        glm::vec3 lo;
+        glm::vec3 hi;
+        [[nodiscard]] Overlap overlap(const glm::vec3& lo, const glm::vec3& hi) const noexcept;
+        [[nodiscard]] bool contains(const glm::vec3& p) const noexcept;
+    };
+
+    struct Hit {
+        uint32_t id = NONE;
+        float distance = 0.0f;                  // A lo largo del rayo (dirección normalizada)
+    };
+
+    // Radio de cada punto: amplía las cajas y es el de las esferas del picking
+    explicit Octree(float radius = 0.0f) noexcept : _radius(radius) {}
+
+    // Posiciones por id: el llamador las rellena y llama a commit()
+    [[nodiscard]] glm::vec3* positions(uint32_t count);
+    void commit();                                      // Todos los puntos
+    void commit(uint32_t begin, uint32_t end);          // Solo se movieron los ids [begin, end)
+    void reorder() noexcept { _ordered = false; }
+
+    // Sincroniza con las posiciones de los nodos de la red: reconstruye si es
+    // otra red y si no reajusta el rango sucio de NodePositions. Solo antes de
+    // que el render mueva la red (Arcane::layoutApplied)
+    void update(const Arcane& arcane);
+
+    // Punto más cercano cuya esfera corta el rayo; id == NONE si ninguno
+    [[nodiscard]] Hit pick(const glm::vec3& origin, const glm::vec3& direction) const noexcept;
+
+    // Ids de los puntos dentro de la forma (se añaden a `out`); devuelve cuántos
+    uint32_t queryRadius(const glm::vec3& center, float radius, DynamicArray<uint32_t>& out) const;
+    uint32_t queryBox(const glm::vec3& lo, const glm::vec3& hi, DynamicArray<uint32_t>& out) const;
+
+    // Recorrido genérico: visit(id) para cada punto dentro de `shape`. Las
+    // celdas Inside se visitan enteras sin probar sus puntos
+    template<typename Shape, typename Visit>
+    void query(const Shape& shape, Visit&& visit) const;
+
+    [[nodiscard]] const std::vector<Cell>& cells() const noexcept { return _cells; }
+    [[nodiscard]] const uint32_t* order() const noexcept { return _order.data(); }
+    [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(_positions.size()); }
+    [[nodiscard]] float radius() const noexcept { return _radius; }
+
+    void clear() noexcept;
+
+private:
+    void build();
+    void refit(bool all);
+    void refitCell(Cell& cell) noexcept;
+
+    float _radius = 0.0f;
+    std::vector<glm::vec3> _positions;      // Por id
+    std::vector<uint64_t> _keys;            // (Morton << 32 | id), ordenadas
+    std::vector<uint32_t> _order;           // Ids en orden Morton
+    std::vector<uint32_t> _leafOf;          // Id -> hoja que lo contiene
+    std::vector<Cell> _cells;
+    std::vector<uint32_t> _levels;          // Primera celda de cada nivel (+ final)
+    std::vector<uint8_t> _dirty;            // Por celda, durante un reajuste parcial
+    bool _ordered = false;
+
+    // Red sincronizada por update()
+    uint64_t _network = 0;
+    uint64_t _version = 0;
+};
+
+template<typename Shape, typename Visit>
+void Octree::query(const Shape& shape, Visit&& visit) const {
+    if (_cells.empty() || _cells[0].count == 0) return;
+
+    // Pila de profundidad acotada: a lo sumo 7 hermanos pendientes por nivel
+    uint32_t stack[8 * (MAX_DEPTH + 1)];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = _cells[stack[--top]];
+        const Overlap overlap = shape.overlap(cell.lo, cell.hi);
+        if (overlap == Overlap::Outside) continue;
+
+        if (overlap == Overlap::Inside) {
+            for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) visit(_order[k]);
+        } else if (cell.childCount == 0) {
+            for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) {
+                if (shape.contains(_positions[_order[k]])) visit(_order[k]);
+            }
+        } else {
+            for (uint32_t c = 0; c < cell.childCount; ++c) stack[top++] = cell.firstChild + c;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "DynamicArray.hpp"
+
+#include <cstdint>
+
+// Caché de resultados de findPath.
+// - LRU acotada de rutas ya resueltas, con clave (origen, destino, modo).
+// - Árboles de caminos mínimos (padres de un BFS completo) de los últimos
+//   orígenes: un BFS responde cualquier destino posterior desde ese origen.
+// Cada entrada guarda la versión de la red; si no coincide con la actual se
+// trata como fallo, de modo que regenerar o mutar la red la invalida.
+class PathCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;          // Ruta servida desde la LRU
+        uint64_t treeHits = 0;      // Ruta extraída de un árbol ya calculado
+        uint64_t misses = 0;        // Hubo que recorrer la red
+    };
+
+    // ----- Constructores -----
+    explicit PathCache(uint32_t capacity = 64, uint32_t treeCapacity = 4);
+    PathCache(PathCache&& other) noexcept = default;
+    PathCache& operator=(PathCache&& other) noexcept = default;
+
+    // ----- Metodos -----
+    // Ruta como ids de nodos (vacía si no hay camino); nullptr si no está en caché
+    const DynamicArray<uint32_t>* find(uint64_t version, uint32_t origen, uint32_t destino, uint8_t mode);
+    void insert(uint64_t version, uint32_t origen, uint32_t destino, uint8_t mode,
+                DynamicArray<uint32_t>&& path);
+
+    // Padres del BFS desde `origen` (-1 = sin padre); nullptr si no está en caché
+    const DynamicArray<int32_t>* findTree(uint64_t version, uint32_t origen);
+    // Reserva una ranura para el árbol de `origen` (reemplaza la menos usada)
+    DynamicArray<int32_t>& insertTree(uint64_t version, uint32_t origen);
+
+    void clear() noexcept;
+
+    const Stats& stats() const noexcept { return _stats; }
+    void recordTreeHit() noexcept { ++_stats.treeHits; }
+    void recordMiss() noexcept { ++_stats.misses; }
+
+private:
+    struct Entry {
+        uint64_t version = 0;
+        uint64_t lastUse = 0;
+        uint32_t origen = 0;
+        uint32_t destino = 0;
+        uint8_t mode = 0;
+        bool valid = false;
+        DynamicArray<uint32_t> path;
+    };
+
+    struct Tree {
+        uint64_t version = 0;
+        uint64_t lastUse = 0;
+        uint32_t origen = 0;
+        bool valid = false;
+        DynamicArray<int32_t> parent;
+    };
+
+    // Pocas entradas: búsqueda lineal y expulsión por marca de uso más antigua
+    DynamicArray<Entry> _entries;
+    DynamicArray<Tree> _trees;
+    uint64_t _tick = 0;
+    Stats _stats;
+};
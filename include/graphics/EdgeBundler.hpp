@@ -0,0 +1,95 @@
+#pragma once
+#include "graphics/LodBinner.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Arcane;
+
+// Agregación de flechas para la vista de conjunto. Cada capa de nivel se
+// divide en celdas por dirección (rejilla de latitud x longitud) y las
+// flechas con la misma celda de origen y de destino forman un haz, que se
+// dibuja como una sola flecha entre los centroides con grosor según cuántas
+// agrupa: O(celdas²) instancias en vez de O(flechas).
+// Una celda se abre cuando la cámara está cerca en relación con su tamaño, y
+// los haces que tocan una celda abierta se dibujan flecha a flecha. Si solo se
+// mueven nodos (rango sucio de NodePositions) se recolocan sus flechas sin
+// reconstruir el resto.
+class EdgeBundler {
+public:
+    static constexpr uint32_t STACKS = 4;
+    static constexpr uint32_t SECTORS = 8;
+    static constexpr uint32_t CELLS_PER_SHELL = STACKS * SECTORS;
+    static constexpr float OPEN_DISTANCE = 1.0f;        // En tamaños de celda
+    static constexpr float MAX_WIDTH = 8.0f;            // Grosor máximo de un haz (1 = flecha)
+
+    // Sincroniza con la red: la reconstruye si cambiaron las conexiones y si
+    // no solo recoloca los nodos movidos y recalcula los colores si cambiaron
+    void update(const Arcane& arcane);
+
+    // Abre las celdas cercanas a `eye` y reparte las flechas (nullptr = todas,
+    // en orden) entre las que se dibujan sueltas y los haces cerrados.
+    // Devuelve cuántas quedan sueltas; sus ids, en el orden de entrada, en expandedIds()
+    uint32_t expand(const glm::vec3& eye, const uint32_t* ids, uint32_t count);
+    [[nodiscard]] const uint32_t* expandedIds() const noexcept { return _partition.ids(); }
+
+    // Haces cerrados tras expand(): instancias para la malla de flecha
+    [[nodiscard]] uint32_t collapsedCount() const noexcept { return static_cast<uint32_t>(_collapsed.size()); }
+    [[nodiscard]] uint32_t collapsedArrows() const noexcept { return _collapsedArrows; }
+    void writeTransforms(glm::mat4* dst) const noexcept;
+    void writeColors(glm::vec3* dst) const noexcept;
+
+    [[nodiscard]] uint32_t bundleCount() const noexcept { return _activeBundles; }
+    void clear() noexcept;
+
+private:
+    struct Bundle {
+        uint32_t origin = 0;                    // Celdas
+        uint32_t destination = 0;
+        uint32_t count = 0;                     // Flechas; 0 = hueco reutilizable
+        glm::vec3 originSum{0.0f};              // Sumas de posiciones y colores de las flechas
+        glm::vec3 destinationSum{0.0f};
+        glm::vec3 colorSum{0.0f};
+    };
+
+    struct Cell {
+        glm::vec3 sum{0.0f};                    // Posiciones de sus nodos
+        uint32_t count = 0;
+    };
+
+    [[nodiscard]] uint32_t cellOf(uint32_t level, const glm::vec3& position) const noexcept;
+    void rebuild(const Arcane& arcane);
+    void moveNodes(const Arcane& arcane, uint32_t begin, uint32_t end);
+    void recolor(const Arcane& arcane);
+    void addArrow(uint32_t arrow, const glm::vec3& color);
+    void removeArrow(uint32_t arrow, const glm::vec3& color);
+
+    // Estado de Arcane con el que se sincronizó
+    uint64_t _network = 0;
+    uint64_t _positions = 0;
+    uint64_t _colors = 0;
+
+    uint32_t _levels = 0;
+    std::vector<Cell> _cells;                   // [nivel * CELLS_PER_SHELL + celda]
+    std::vector<uint8_t> _open;
+
+    std::vector<uint32_t> _nodeCell;
+    std::vector<glm::vec3> _nodePosition;       // Posición incluida en las sumas
+    std::vector<uint32_t> _arrowOrigin;         // Ids de nodo de cada flecha
+    std::vector<uint32_t> _arrowDestination;
+    std::vector<uint32_t> _arrowBundle;
+    std::vector<uint32_t> _incidenceFirst;      // Flechas de cada nodo (CSR, salida y entrada)
+    std::vector<uint32_t> _incidence;
+
+    std::vector<Bundle> _bundles;
+    std::unordered_map<uint64_t, uint32_t> _bundleIndex;       // (origen << 32 | destino) -> haz
+    uint32_t _activeBundles = 0;
+
+    LodBinner _partition;                       // Nivel 0: sueltas, 1: en un haz cerrado
+    std::vector<uint32_t> _collapsed;           // Haces cerrados
+    uint32_t _collapsedArrows = 0;
+    std::vector<float> _ends[6];                // Centroides en SoA para ArrowKernel (ox, oy, oz, dx, dy, dz)
+};
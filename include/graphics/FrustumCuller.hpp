@@ -0,0 +1,60 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Planos del frustum extraídos de projection * view (Gribb-Hartmann),
+// normalizados para comparar distancias con radios de esferas
+struct Frustum {
+    enum class Result : uint8_t { Outside, Inside, Intersects };
+
+    glm::vec4 planes[6];        // xyz = normal hacia dentro, w = distancia
+
+    [[nodiscard]] static Frustum fromMatrix(const glm::mat4& viewProjection) noexcept;
+    [[nodiscard]] Result classify(const glm::vec4& sphere) const noexcept;
+};
+
+// Culling de elementos con esfera envolvente (xyz = centro, w = radio).
+// Los elementos se agrupan en clusters de CLUSTER_SIZE ordenados por código
+// Morton del centro, cada uno con su propia esfera: los clusters fuera del
+// frustum se descartan enteros, los de dentro se aceptan enteros y solo los
+// que cortan un plano prueban elemento a elemento. Si cambia el número de
+// elementos se reordena; si solo se mueven, se reajustan las esferas de los
+// clusters en O(N). La prueba y la compactación de ids (recuento por cluster,
+// suma de prefijos y escritura) se reparten entre los hilos del pool.
+class FrustumCuller {
+public:
+    static constexpr uint32_t CLUSTER_SIZE = 64;
+
+    // Esferas de los elementos, por id: el llamador las rellena y llama a commit()
+    [[nodiscard]] glm::vec4* spheres(uint32_t count);
+    void commit();
+
+    // Calcula los ids visibles (en orden de cluster) y devuelve cuántos son
+    uint32_t cull(const glm::mat4& viewProjection);
+
+    [[nodiscard]] const uint32_t* visible() const noexcept { return _visible.data(); }
+    [[nodiscard]] uint32_t visibleCount() const noexcept { return _visibleCount; }
+    [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(_spheres.size()); }
+
+    void clear() noexcept;
+
+private:
+    struct Cluster {
+        glm::vec4 sphere;
+        uint32_t begin;         // Rango en _order
+        uint32_t end;
+    };
+
+    std::vector<glm::vec4> _spheres;        // Por id
+    std::vector<uint32_t> _order;           // Ids ordenados por código Morton
+    std::vector<Cluster> _clusters;
+    std::vector<uint32_t> _clusterOffsets;  // Visibles por cluster -> primer índice de salida
+    std::vector<uint8_t> _itemVisible;      // Por posición en _order (clusters parciales)
+    std::vector<uint32_t> _visible;
+    uint32_t _visibleCount = 0;
+    bool _ordered = false;
+
+    void buildOrder();
+    void refitClusters();
+};
@@ -1,28 +1,324 @@
 #pragma once
-#include <vector>
-#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <numbers>
+#include <type_traits>
 
+// Mallas generadas en tiempo de compilación: las dimensiones (stacks,
+// sectores, segmentos) son parámetros de plantilla y el resultado son
+// std::array constexpr, así que el arranque no calcula nada y los datos van
+// en la sección de solo lectura. Los índices son de 16 bits mientras haya
+// menos de 65536 vértices y los triángulos se reordenan para la caché de
+// vértices (algoritmo de Forsyth).
 class Geometry {
 public:
-    // Esferas
-    [[nodiscard]] static std::vector<float> generateSphereVertices(
-        float radius = 0.2f, 
-        unsigned int stacks = 16, 
-        unsigned int sectors = 32);
-    
-    [[nodiscard]] static std::vector<unsigned int> generateSphereIndices(
-        unsigned int stacks = 16, 
-        unsigned int sectors = 32);
-    
-    // Flechas
-    [[nodiscard]] static std::vector<float> generateArrowVertices(
-        float shaftLength = 0.8f,
-        float shaftRadius = 0.02f,
-        float headLength = 0.2f,
-        float headRadius = 0.05f,
-        unsigned int segments = 16);
-    
-    [[nodiscard]] static std::vector<unsigned int> generateArrowIndices(
-        unsigned int segments = 16);
-};
\ No newline at end of file
+    template <size_t Vertices, size_t Indices>
+    struct Mesh {
+        using Index = std::conditional_t<(Vertices < 65536), uint16_t, uint32_t>;
+        static constexpr size_t VERTEX_COUNT = Vertices;
+        static constexpr size_t INDEX_COUNT = Indices;
+
+        std::array<float, Vertices * 3> vertices{};     // xyz
+        std::array<Index, Indices> indices{};
+    };
+
+    // Esfera UV: los polos repiten un vértice por sector
+    template <unsigned int Stacks, unsigned int Sectors>
+    struct Sphere {
+        static_assert(Stacks >= 2 && Sectors >= 3, "La esfera necesita al menos 2 stacks y 3 sectores");
+        using Type = Mesh<(Stacks + 1) * (Sectors + 1), Sectors * (Stacks - 1) * 6>;
+
+        [[nodiscard]] static constexpr Type generate(float radius = 0.2f);
+    };
+
+    // Cilindro (shaft) y cono (head) a lo largo de +Z
+    template <unsigned int Segments>
+    struct Arrow {
+        static_assert(Segments >= 3, "La flecha necesita al menos 3 segmentos");
+        using Type = Mesh<(Segments + 1) * 3 + 1, Segments * 9>;
+
+        [[nodiscard]] static constexpr Type generate(float shaftLength = 0.8f, float shaftRadius = 0.02f,
+                                                     float headLength = 0.2f, float headRadius = 0.05f);
+    };
+
+    // Flecha reducida a un segmento de la base al ápice (se dibuja con GL_LINES)
+    struct ArrowLine {
+        using Type = Mesh<2, 2>;
+
+        [[nodiscard]] static constexpr Type generate(float length = 1.0f) {
+            return {{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, length}, {0, 1}};
+        }
+    };
+
+    // Reordena los triángulos para la caché de vértices (Tom Forsyth, "Linear-
+    // Speed Vertex Cache Optimisation"): en cada paso emite el triángulo con
+    // más puntuación entre los que tocan la caché LRU simulada. La puntuación
+    // de un vértice premia estar reciente en la caché y tener pocos
+    // triángulos pendientes, para terminar las zonas ya empezadas.
+    template <size_t Vertices, typename Index, size_t Indices>
+    [[nodiscard]] static constexpr std::array<Index, Indices> optimizeVertexCache(
+        const std::array<Index, Indices>& indices);
+
+private:
+    static constexpr double PI = std::numbers::pi;
+    static constexpr size_t CACHE_SIZE = 32;
+    static constexpr size_t MAX_VALENCE_SCORE = 32;     // Más triángulos pendientes puntúan como 31
+
+    // std::sin/std::sqrt no son constexpr en C++20: serie de Taylor tras
+    // reducir a [-pi, pi] y Newton-Raphson
+    static constexpr double sine(double x) {
+        while (x > PI) x -= 2.0 * PI;
+        while (x < -PI) x += 2.0 * PI;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 16; ++n) {
+            term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static constexpr double cosine(double x) {
+        return sine(x + PI / 2.0);
+    }
+
+    static constexpr double squareRoot(double x) {
+        if (x <= 0.0) return 0.0;
+        double root = x > 1.0 ? x : 1.0;
+        for (int i = 0; i < 64; ++i) {
+            const double next = 0.5 * (root + x / root);
+            if (next == root) break;
+            root = next;
+        }
+        return root;
+    }
+};
+
+// ----- Generadores -----
+
+template <unsigned int Stacks, unsigned int Sectors>
+constexpr typename Geometry::Sphere<Stacks, Sectors>::Type Geometry::Sphere<Stacks, Sectors>::generate(float radius) {
+    using Index = typename Type::Index;
+    Type mesh;
+
+    size_t v = 0;
+    for (unsigned int i = 0; i <= Stacks; ++i) {
+        const double stackAngle = PI / 2.0 - i * PI / Stacks;
+        const double xy = radius * cosine(stackAngle);
+        const double z = radius * sine(stackAngle);
+
+        for (unsigned int j = 0; j <= Sectors; ++j) {
+            const double sectorAngle = j * 2.0 * PI / Sectors;
+            mesh.vertices[v++] = static_cast<float>(xy * cosine(sectorAngle));
+            mesh.vertices[v++] = static_cast<float>(xy * sine(sectorAngle));
+            mesh.vertices[v++] = static_cast<float>(z);
+        }
+    }
+
+    // Sin los triángulos degenerados de los polos
+    std::array<Index, Type::INDEX_COUNT> indices{};
+    size_t n = 0;
+    for (unsigned int i = 0; i < Stacks; ++i) {
+        unsigned int k1 = i * (Sectors + 1);
+        unsigned int k2 = k1 + Sectors + 1;
+
+        for (unsigned int j = 0; j < Sectors; ++j, ++k1, ++k2) {
+            if (i != 0) {
+                indices[n++] = static_cast<Index>(k1);
+                indices[n++] = static_cast<Index>(k2);
+                indices[n++] = static_cast<Index>(k1 + 1);
+            }
+            if (i != Stacks - 1) {
+                indices[n++] = static_cast<Index>(k1 + 1);
+                indices[n++] = static_cast<Index>(k2);
+                indices[n++] = static_cast<Index>(k2 + 1);
+            }
+        }
+    }
+    mesh.indices = optimizeVertexCache<Type::VERTEX_COUNT>(indices);
+    return mesh;
+}
+
+template <unsigned int Segments>
+constexpr typename Geometry::Arrow<Segments>::Type Geometry::Arrow<Segments>::generate(
+    float shaftLength, float shaftRadius, float headLength, float headRadius) {
+    using Index = typename Type::Index;
+    Type mesh;
+
+    // Cilindro: pares (base, tapa) por segmento
+    size_t v = 0;
+    for (unsigned int i = 0; i <= Segments; ++i) {
+        const double theta = 2.0 * PI * i / Segments;
+        const float x = static_cast<float>(cosine(theta));
+        const float y = static_cast<float>(sine(theta));
+        for (float z : {0.0f, shaftLength}) {
+            mesh.vertices[v++] = x * shaftRadius;
+            mesh.vertices[v++] = y * shaftRadius;
+            mesh.vertices[v++] = z;
+        }
+    }
+
+    // Base del cono
+    for (unsigned int i = 0; i <= Segments; ++i) {
+        const double theta = 2.0 * PI * i / Segments;
+        mesh.vertices[v++] = static_cast<float>(cosine(theta)) * headRadius;
+        mesh.vertices[v++] = static_cast<float>(sine(theta)) * headRadius;
+        mesh.vertices[v++] = shaftLength;
+    }
+
+    // Ápice del cono
+    mesh.vertices[v++] = 0.0f;
+    mesh.vertices[v++] = 0.0f;
+    mesh.vertices[v++] = shaftLength + headLength;
+
+    std::array<Index, Type::INDEX_COUNT> indices{};
+    size_t n = 0;
+    for (unsigned int i = 0; i < Segments; ++i) {
+        const unsigned int base = i * 2;
+        for (unsigned int index : {base, base + 1, base + 3, base, base + 3, base + 2}) {
+            indices[n++] = static_cast<Index>(index);
+        }
+    }
+
+    const unsigned int offset = (Segments + 1) * 2;
+    const unsigned int apex = offset + Segments + 1;
+    for (unsigned int i = 0; i < Segments; ++i) {
+        indices[n++] = static_cast<Index>(offset + i);
+        indices[n++] = static_cast<Index>(offset + i + 1);
+        indices[n++] = static_cast<Index>(apex);
+    }
+    mesh.indices = optimizeVertexCache<Type::VERTEX_COUNT>(indices);
+    return mesh;
+}
+
+// ----- Orden para la caché de vértices -----
+
+template <size_t Vertices, typename Index, size_t Indices>
+constexpr std::array<Index, Indices> Geometry::optimizeVertexCache(const std::array<Index, Indices>& indices) {
+    static_assert(Indices % 3 == 0, "Se esperan triángulos");
+    constexpr size_t TRIANGLES = Indices / 3;
+
+    // Arrays locales en vez de std::array: la evaluación constexpr cuenta
+    // cada llamada a operator[] y el límite de operaciones es estricto
+
+    // Puntuaciones tabuladas: posición en la caché y triángulos pendientes
+    double cacheScore[CACHE_SIZE + 1]{};        // El último: fuera de la caché
+    for (size_t i = 0; i < CACHE_SIZE; ++i) {
+        if (i < 3) {
+            cacheScore[i] = 0.75;               // Los del último triángulo, fijo para no favorecer tiras
+        } else {
+            const double s = 1.0 - static_cast<double>(i - 3) / static_cast<double>(CACHE_SIZE - 3);
+            cacheScore[i] = s * squareRoot(s);  // s^1.5
+        }
+    }
+    double valenceScore[MAX_VALENCE_SCORE]{};
+    for (size_t i = 1; i < MAX_VALENCE_SCORE; ++i) {
+        valenceScore[i] = 2.0 / squareRoot(static_cast<double>(i));
+    }
+
+    // Triángulos pendientes de cada vértice (CSR): los vivos ocupan
+    // [start[v], start[v] + valence[v])
+    uint32_t start[Vertices + 1]{};
+    uint32_t valence[Vertices]{};
+    uint32_t adjacency[Indices]{};
+    uint32_t triangleVertices[Indices]{};
+    for (size_t i = 0; i < Indices; ++i) {
+        triangleVertices[i] = indices[i];
+        ++valence[triangleVertices[i]];
+    }
+    for (size_t v = 0; v < Vertices; ++v) start[v + 1] = start[v] + valence[v];
+    {
+        uint32_t filled[Vertices]{};
+        for (size_t i = 0; i < Indices; ++i) {
+            const uint32_t v = triangleVertices[i];
+            adjacency[start[v] + filled[v]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    // La puntuación de un triángulo es la suma de las de sus vértices; se
+    // mantiene sumando la diferencia cuando cambia la de un vértice
+    uint32_t cachePosition[Vertices]{};
+    double vertexScore[Vertices]{};
+    double triangleScore[TRIANGLES]{};
+    for (size_t v = 0; v < Vertices; ++v) {
+        cachePosition[v] = CACHE_SIZE;
+        vertexScore[v] = valence[v] == 0 ? 0.0
+                       : valenceScore[valence[v] < MAX_VALENCE_SCORE ? valence[v] : MAX_VALENCE_SCORE - 1];
+    }
+    for (size_t i = 0; i < Indices; ++i) triangleScore[i / 3] += vertexScore[triangleVertices[i]];
+
+    std::array<Index, Indices> result{};
+    bool emitted[TRIANGLES]{};
+    uint32_t cache[CACHE_SIZE + 3]{};
+    size_t cacheCount = 0;
+    size_t best = TRIANGLES;
+
+    for (size_t n = 0; n < TRIANGLES; ++n) {
+        // Sin candidatos en la caché (inicio o zona terminada): el mejor de todos
+        if (best == TRIANGLES) {
+            double bestScore = -1.0;
+            for (size_t t = 0; t < TRIANGLES; ++t) {
+                if (!emitted[t] && triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        // Emitir y sacarlo de las listas de sus vértices
+        emitted[best] = true;
+        uint32_t next[CACHE_SIZE + 3]{};
+        size_t nextCount = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            const uint32_t v = triangleVertices[3 * best + k];
+            result[3 * n + k] = static_cast<Index>(v);
+            next[nextCount++] = v;
+
+            const uint32_t last = start[v] + --valence[v];
+            for (uint32_t a = start[v]; a < last; ++a) {
+                if (adjacency[a] == best) {
+                    adjacency[a] = adjacency[last];
+                    break;
+                }
+            }
+        }
+
+        // LRU: los del triángulo al frente, el resto detrás en su orden
+        for (size_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if (v != next[0] && v != next[1] && v != next[2]) next[nextCount++] = v;
+        }
+
+        // Repuntuar los vértices de la caché (y los que acaban de salir) y
+        // propagar la diferencia a sus triángulos pendientes
+        for (size_t i = 0; i < nextCount; ++i) {
+            const uint32_t v = next[i];
+            cachePosition[v] = i < CACHE_SIZE ? static_cast<uint32_t>(i) : CACHE_SIZE;
+            const double score = valence[v] == 0 ? 0.0
+                               : valenceScore[valence[v] < MAX_VALENCE_SCORE ? valence[v] : MAX_VALENCE_SCORE - 1] +
+                                 cacheScore[cachePosition[v]];
+            const double delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for (uint32_t a = start[v], end = start[v] + valence[v]; a < end; ++a) {
+                triangleScore[adjacency[a]] += delta;
+            }
+        }
+
+        // El siguiente es el mejor de los que tocan la caché
+        best = TRIANGLES;
+        double bestScore = -1.0;
+        cacheCount = nextCount < CACHE_SIZE ? nextCount : CACHE_SIZE;
+        for (size_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = next[i];
+            cache[i] = v;
+            for (uint32_t a = start[v], end = start[v] + valence[v]; a < end; ++a) {
+                if (triangleScore[adjacency[a]] > bestScore) {
+                    bestScore = triangleScore[adjacency[a]];
+                    best = adjacency[a];
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+
+// Tiempos de GPU con consultas GL_TIME_ELAPSED en dos juegos alternos: el
+// frame N mide con un juego y al terminar lee el del frame N-1 solo si
+// GL_QUERY_RESULT_AVAILABLE ya lo indica, así que leer nunca bloquea. Un
+// resultado que aún no llegó conserva el valor anterior. Los intervalos no se
+// pueden anidar (una sola consulta TIME_ELAPSED activa a la vez).
+class GpuTimer {
+public:
+    static constexpr uint32_t MAX_TIMERS = 8;
+
+    ~GpuTimer();
+
+    void initialize();
+    void destroy() noexcept;
+
+    void begin(uint32_t timer) noexcept;
+    void end() noexcept;
+
+    // Cierra el frame: recoge los resultados disponibles del juego anterior
+    void endFrame() noexcept;
+
+    [[nodiscard]] double milliseconds(uint32_t timer) const noexcept { return _milliseconds[timer]; }
+
+private:
+    std::array<std::array<GLuint, MAX_TIMERS>, 2> _queries{};
+    std::array<std::array<bool, MAX_TIMERS>, 2> _issued{};
+    std::array<double, MAX_TIMERS> _milliseconds{};
+    uint32_t _set = 0;
+    uint32_t _active = MAX_TIMERS;      // Timer con la consulta abierta
+    bool _initialized = false;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Reparto de instancias por nivel de detalle. El llamador escribe el nivel de
+// cada elemento de la lista (en paralelo) y bin() los agrupa por nivel
+// conservando el orden relativo, de modo que cada nivel queda como un rango
+// contiguo que se dibuja con una sola llamada instanciada. El recuento por
+// bloque, la suma de prefijos y la escritura se reparten entre los hilos del
+// pool, como la compactación de FrustumCuller.
+class LodBinner {
+public:
+    static constexpr uint32_t MAX_LEVELS = 4;
+
+    // Nivel de cada posición de la lista a repartir: el llamador los rellena y llama a bin()
+    [[nodiscard]] uint8_t* levels(uint32_t count);
+
+    // Agrupa los ids (nullptr = identidad, la posición es el id) por nivel
+    void bin(const uint32_t* ids);
+
+    [[nodiscard]] const uint32_t* ids() const noexcept { return _ids.data(); }
+    [[nodiscard]] uint32_t first(uint32_t level) const noexcept { return _first[level]; }
+    [[nodiscard]] uint32_t count(uint32_t level) const noexcept { return _first[level + 1] - _first[level]; }
+    [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(_levels.size()); }
+
+    void clear() noexcept;
+
+private:
+    std::vector<uint8_t> _levels;               // Por posición en la lista de entrada
+    std::vector<uint32_t> _blockOffsets;        // [bloque * MAX_LEVELS + nivel]
+    std::vector<uint32_t> _ids;                 // Ids agrupados por nivel
+    std::array<uint32_t, MAX_LEVELS + 1> _first{};
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include "graphics/Renderer.hpp"
+#include "ui/GUI.hpp"
+#include "utils/TripleBuffer.hpp"
+#include "core/DynamicArray.hpp"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+
+class Arcane;
+class Node;
+struct Neighborhood;
+
+// Ajustes del renderer elegidos en la GUI; el hilo de render aplica los que cambian
+struct RenderSettings {
+    ArrowRenderMode arrowMode = ArrowRenderMode::Matrices;
+    SphereRenderMode sphereMode = SphereRenderMode::Impostor;
+    bool streaming = false;
+    bool culling = false;
+    bool levelOfDetail = false;
+    bool gpuCulling = false;
+    bool paletteColors = false;
+    bool edgeBundling = false;
+
+    bool operator==(const RenderSettings&) const = default;
+};
+
+// Todo lo que el hilo de render necesita para dibujar un frame. El hilo de
+// simulación/UI lo escribe entero en cada frame; lo compartido (la red y los
+// estados de resaltado) va en shared_ptr y no se modifica después de
+// publicarse, salvo los colores y las posiciones de Arcane, que solo toca el
+// hilo de render (el reparto por campos está en Arcane.hpp).
+struct FrameSnapshot {
+    uint64_t frame = 0;
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    int width = 0;
+    int height = 0;
+    RenderSettings settings;
+
+    // Al regenerar se publica otra red y los estados vuelven a nulo
+    std::shared_ptr<Arcane> arcane;
+
+    // Estados de resaltado con versión: se aplican solo cuando la versión
+    // cambia, así que un snapshot descartado no pierde ninguno
+    uint64_t pathVersion = 0;
+    std::shared_ptr<const DynamicArray<const Node*>> path;     // Nulo = sin ruta
+    uint64_t metricVersion = 0;
+    std::shared_ptr<const DynamicArray<float>> metric;         // Nulo = colores por nivel
+    uint64_t focusVersion = 0;
+    std::shared_ptr<const Neighborhood> focus;                 // Nulo = sin foco
+    uint64_t layoutVersion = 0;
+    std::shared_ptr<const DynamicArray<glm::vec3>> layout;     // Posiciones por id; nulo = las generadas
+
+    GUI::DrawDataCopy ui;
+};
+
+// Resultados del render para las estadísticas de la GUI
+struct RenderStats {
+    uint64_t frame = 0;                 // Snapshot dibujado
+    uint64_t uploadedBytes = 0;
+    bool culling = false;
+    Renderer::CullStats cull;
+    bool levelOfDetail = false;
+    Renderer::DrawStats draw;
+};
+
+// Hilo dueño del contexto GL: dibuja el último snapshot publicado a la tasa
+// de la pantalla (VSync) aunque el hilo de UI tarde varios frames en una
+// consulta o en regenerar la red. Ambos sentidos usan TripleBuffer, sin locks.
+class RenderThread {
+public:
+    ~RenderThread();
+
+    // Suelta el contexto del hilo llamador y lo hace actual en el hilo de
+    // render, que inicializa el Renderer y el backend OpenGL de ImGui.
+    // Bloquea hasta que termina la inicialización.
+    bool start(GLFWwindow* window, GUI& gui);
+    void stop();
+
+    // ----- Hilo de UI -----
+    [[nodiscard]] FrameSnapshot& snapshot() noexcept { return _snapshots.back(); }
+    void publish() noexcept { _snapshots.publish(); }
+
+    // Espera a que se presente un frame desde la última espera: la UI va
+    // como mucho un frame por delante y no gira en vacío
+    void waitForPresent() noexcept;
+
+    // Últimas estadísticas publicadas por el hilo de render
+    [[nodiscard]] const RenderStats& stats() noexcept;
+
+private:
+    void run(GUI& gui);
+    void apply(FrameSnapshot& frame);
+
+    GLFWwindow* _window = nullptr;
+    std::thread _thread;
+    std::atomic<bool> _stop{false};
+    std::promise<bool> _ready;                  // Resultado de la inicialización
+    std::atomic<uint64_t> _presented{0};
+    uint64_t _waited = 0;                       // Solo el hilo de UI
+
+    TripleBuffer<FrameSnapshot> _snapshots;
+    TripleBuffer<RenderStats> _stats;
+
+    // ----- Solo el hilo de render -----
+    std::unique_ptr<Renderer> _renderer;
+    std::shared_ptr<Arcane> _arcane;            // Red con los estados aplicados
+    RenderSettings _settings;
+    uint64_t _pathVersion = 0;
+    uint64_t _metricVersion = 0;
+    uint64_t _focusVersion = 0;
+    uint64_t _layoutVersion = 0;
+    int _width = 0;
+    int _height = 0;
+    uint32_t _framePhase = 0;
+};
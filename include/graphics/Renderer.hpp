@@ -6,9 +6,30 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <span>
+
+#include "graphics/StreamBuffer.hpp"
+#include "graphics/FrustumCuller.hpp"
+#include "graphics/LodBinner.hpp"
+#include "graphics/EdgeBundler.hpp"
+#include "graphics/ShaderManager.hpp"
+#include "graphics/GpuTimer.hpp"
 
 class Arcane;
-class ShaderManager;
+struct Neighborhood;
+struct InstanceVersion;
+
+// Datos de instancia de las flechas
+enum class ArrowRenderMode : uint8_t {
+    Matrices,       // glm::mat4 por flecha calculada en CPU (64 bytes)
+    Endpoints       // Origen y destino (24 bytes); la matriz se construye en el vertex shader
+};
+
+// Geometría de los nodos
+enum class SphereRenderMode : uint8_t {
+    Mesh,           // Malla de esfera instanciada (stacks x sectors de Geometry)
+    Impostor        // Quad orientado a la cámara; el fragment shader lanza el rayo contra la esfera
+};
 
 class Renderer {
 public:
@@ -22,34 +43,297 @@ public:
     void setViewMatrix(const glm::mat4& view) noexcept { this->view = view; }
     void setProjectionMatrix(const glm::mat4& projection) noexcept { this->projection = projection; }
     
+    // Atenúa todo lo que quede fuera del conjunto (solo sube una máscara de 1 byte por instancia)
+    void setFocus(const Arcane& arcane, const Neighborhood& focus);
+    void clearFocus();
+    [[nodiscard]] bool hasFocus() const noexcept { return focusActive; }
+    
+    void setArrowMode(ArrowRenderMode mode);
+    [[nodiscard]] ArrowRenderMode getArrowMode() const noexcept { return arrowMode; }
+    
+    // Impostor recae en Mesh si su shader no compiló
+    void setSphereMode(SphereRenderMode mode);
+    [[nodiscard]] SphereRenderMode getSphereMode() const noexcept { return sphereMode; }
+    
+    // Triángulos dibujados por nodo en el modo actual
+    [[nodiscard]] uint32_t getSphereTriangles() const noexcept;
+    
+    // Posiciones y geometría de flechas escritas cada frame en un anillo de
+    // tres regiones (mapeo persistente si hay ARB_buffer_storage), para
+    // layouts animados. Colores y máscaras siguen la subida por versiones.
+    void setStreaming(bool enabled);
+    [[nodiscard]] bool isStreaming() const noexcept { return streaming; }
+    
+    // Culling por frustum en CPU: solo se compactan, suben y dibujan las
+    // instancias visibles. Tiene prioridad sobre el streaming.
+    struct CullStats {
+        double milliseconds = 0.0;
+        uint32_t visibleNodes = 0;
+        uint32_t totalNodes = 0;
+        uint32_t visibleArrows = 0;
+        uint32_t totalArrows = 0;
+    };
+    void setCulling(bool enabled);
+    [[nodiscard]] bool isCulling() const noexcept { return culling; }
+    [[nodiscard]] const CullStats& getCullStats() const noexcept { return cullStats; }
+    
+    // Nivel de detalle por tamaño proyectado: cada frame las instancias se
+    // reparten por nivel (en paralelo) y se dibuja un rango instanciado por
+    // malla. Las flechas de menos de ARROW_LOD_PIXELS se dibujan como líneas.
+    // Como el culling, compacta las instancias y tiene prioridad sobre el streaming.
+    struct DrawStats {
+        std::array<uint32_t, LodBinner::MAX_LEVELS> nodeLevels{};      // Instancias por nivel
+        std::array<uint32_t, LodBinner::MAX_LEVELS> arrowLevels{};
+        uint64_t triangles = 0;
+        uint32_t lines = 0;
+        uint32_t drawCalls = 0;
+        uint32_t bundles = 0;                       // Haces cerrados dibujados (agrupación de flechas)
+        uint32_t bundledArrows = 0;                 // Flechas representadas por esos haces
+    };
+    void setLevelOfDetail(bool enabled);
+    [[nodiscard]] bool isLevelOfDetail() const noexcept { return levelOfDetail; }
+    [[nodiscard]] const DrawStats& getDrawStats() const noexcept { return drawStats; }
+    
+    // Agrupación de flechas por celdas de las capas de nivel (ver EdgeBundler):
+    // de lejos un haz por par de celdas, de cerca las flechas sueltas. Usa la
+    // compactación de la CPU aunque el culling en GPU esté activo.
+    void setEdgeBundling(bool enabled);
+    [[nodiscard]] bool isEdgeBundling() const noexcept { return edgeBundling; }
+    
+    // Colores por paleta: cada instancia sube un uint32 (índice en la paleta de
+    // Arcane y banderas, ver InstanceStyle) en vez de un vec3 y el shader busca
+    // el color en un uniform. Recolorear por nivel solo cambia el uniform y el
+    // resaltado de una ruta sube 4 bytes por flecha afectada.
+    void setPaletteColors(bool enabled);
+    [[nodiscard]] bool isPaletteColors() const noexcept { return paletteColors; }
+    
+    // Culling y LOD en GPU (GL 4.3): los datos completos de instancia quedan en
+    // SSBO, un compute shader clasifica cada instancia, escribe los ids visibles
+    // por nivel y rellena los comandos de glMultiDrawElementsIndirect. La CPU
+    // no recorre instancias. Se aplica mientras haya culling o LOD activos; las
+    // flechas construyen su matriz a partir de los extremos en ambos modos.
+    // Los recuentos de DrawStats y CullStats llegan con uno o más frames de
+    // retraso (sin esperar a la GPU).
+    [[nodiscard]] bool supportsGpuCulling() const noexcept { return cullProgram.program.valid(); }
+    void setGpuCulling(bool enabled);
+    [[nodiscard]] bool isGpuCulling() const noexcept { return gpuCulling; }
+    
+    // Bytes de instancias subidos en el último render (0 con la red estática)
+    [[nodiscard]] uint64_t getUploadedBytes() const noexcept { return uploadedBytes; }
+    
     [[nodiscard]] static glm::mat4 calculateProjection(float aspectRatio) noexcept;
     
+    // Radio con el que se dibujan los nodos (también el de las esferas del picking)
+    static constexpr float NODE_RADIUS = 0.2f;
+    
 private:
     GLFWwindow* window = nullptr;
     glm::mat4 view;
     glm::mat4 projection;
     std::unique_ptr<ShaderManager> shaderManager;
     
+    // Programas y uniforms resueltos una vez en initialize(); los que un
+    // programa no usa quedan como handles inválidos y se ignoran
+    struct ProgramUniforms {
+        ShaderManager::ProgramHandle program;
+        ShaderManager::UniformHandle view, projection, mvp;
+        ShaderManager::UniformHandle sphereRadius, thickness, radius;
+        ShaderManager::UniformHandle focusActive;
+        ShaderManager::UniformHandle paletteColors, palette, paletteScale, highlightColor;
+    };
+    ProgramUniforms arrowProgram;
+    ProgramUniforms arrowEndpointsProgram;
+    ProgramUniforms sphereProgram;
+    ProgramUniforms impostorProgram;
+    ProgramUniforms arrowIndirectProgram;           // Variantes GL 4.3 que leen los SSBO
+    ProgramUniforms sphereIndirectProgram;
+    ProgramUniforms impostorIndirectProgram;
+    [[nodiscard]] ProgramUniforms resolveProgram(ShaderManager::ProgramHandle program) const;
+    
+    struct CullUniforms {
+        ShaderManager::ProgramHandle program;
+        ShaderManager::UniformHandle viewProjection, depthAxis, depthOffset, focal, radius;
+        ShaderManager::UniformHandle thresholds, levels, count, capacity, commandBase, arrows, culling;
+    };
+    CullUniforms cullProgram;
+    
+    // Estado de un buffer de instancias en la GPU: versión de Arcane subida,
+    // capacidad reservada (en instancias) e instancias válidas
+    struct InstanceUpload {
+        uint64_t version = 0;
+        uint32_t capacity = 0;
+        uint32_t count = 0;
+    };
+    
+    // Índices de 16 bits: todas las mallas de Geometry tienen menos de 65536 vértices
+    using MeshIndex = GLushort;
+    static constexpr GLenum MESH_INDEX_TYPE = GL_UNSIGNED_SHORT;
+    
+    // Malla de un nivel de detalle (datos constexpr de Geometry)
+    struct LodSource {
+        std::span<const float> vertices;
+        std::span<const MeshIndex> indices;
+        GLenum primitive = GL_TRIANGLES;
+    };
+    
+    // Rango de un nivel dentro del VBO/EBO compartido
+    struct LodMesh {
+        GLenum primitive = GL_TRIANGLES;
+        GLsizei indexCount = 0;
+        GLintptr indexOffset = 0;                   // En bytes
+        GLint baseVertex = 0;
+    };
+    
     struct MeshBuffers {
         GLuint VAO = 0, VBO = 0, EBO = 0;
-        std::array<GLuint, 2> instanceVBOs{};
+        GLsizei indexCount = 0;                     // Nivel 0, fijo desde setup*Buffers
+        std::array<LodMesh, LodBinner::MAX_LEVELS> lods{};
+        uint32_t lodCount = 0;
+        std::array<GLuint, 5> instanceVBOs{};      // 0: posición/matriz, 1: color, 2: máscara de foco, 3: extremos, 4: estilo
+        std::array<InstanceUpload, 5> uploads{};
         
+        // Sube todos los niveles a un solo VBO/EBO (el VAO debe estar enlazado)
+        void uploadLods(std::initializer_list<LodSource> sources);
+        void draw(uint32_t level, uint32_t instances) const noexcept;
         void cleanup() noexcept;
     };
     
     MeshBuffers sphereBuffers;
     MeshBuffers arrowBuffers;
     
+    // Buffers del culling en GPU de una malla. Los comandos son uno por nivel
+    // (DrawElementsIndirectCommand) más uno de glDrawArraysIndirect para los
+    // impostores; el nivel N usa los ids [N * capacity, N * capacity + visibles).
+    struct IndirectBuffers {
+        GLuint VAO = 0;                 // Malla de MeshBuffers + id de instancia (location 10)
+        GLuint ids = 0;                 // Escrito por el compute shader, leído como atributo
+        GLuint commands = 0;
+        GLuint readback = 0;            // Copia de los comandos para las estadísticas
+        uint32_t capacity = 0;          // Ids reservados por nivel
+        
+        void setup(const MeshBuffers& mesh);
+        void reserve(uint32_t count);
+        void cleanup() noexcept;
+    };
+    IndirectBuffers sphereIndirect;
+    IndirectBuffers arrowIndirect;
+    bool gpuCulling = false;
+    GLsync gpuStatsFence = nullptr;     // Copia de los comandos pendiente de leer
+    
+    [[nodiscard]] bool gpuDriven() const noexcept { return gpuCulling && compacting() && !edgeBundling; }
+    void updateGpuInstances(const Arcane& arcane);
+    void cullOnGpu(const Arcane& arcane);
+    void readGpuStats();
+    void drawIndirect(const IndirectBuffers& buffers, const MeshBuffers& mesh, uint32_t levels);
+    ArrowRenderMode arrowMode = ArrowRenderMode::Matrices;
+    SphereRenderMode sphereMode = SphereRenderMode::Impostor;
+    bool paletteColors = false;
+    
+    bool streaming = false;
+    StreamBuffer sphereStream;      // Posiciones de nodos
+    StreamBuffer arrowStream;       // Matrices o extremos según arrowMode
+    
+    // Estado con el que se compactaron las instancias: si no cambia
+    // (cámara quieta, datos iguales) el frame no recalcula ni sube nada
+    struct CompactKey {
+        glm::mat4 viewProjection{1.0f};
+        float focalPixels = 0.0f;
+        uint64_t network = 0;
+        uint64_t nodePositions = 0;
+        uint64_t nodeColors = 0;
+        uint64_t arrowGeometry = 0;
+        uint64_t arrowColors = 0;
+        uint64_t focus = 0;
+        ArrowRenderMode mode = ArrowRenderMode::Matrices;
+        SphereRenderMode sphereMode = SphereRenderMode::Impostor;
+        bool culling = false;
+        bool levelOfDetail = false;
+        bool palette = false;
+        bool bundling = false;
+        
+        bool operator==(const CompactKey&) const = default;
+    };
+    
+    bool culling = false;
+    bool levelOfDetail = false;
+    bool compactValid = false;
+    CompactKey lastCompact;
+    CullStats cullStats;
+    DrawStats drawStats;
+    FrustumCuller nodeCuller;
+    FrustumCuller arrowCuller;
+    LodBinner nodeBinner;
+    LodBinner arrowBinner;
+    uint64_t focusGeneration = 0;
+    
+    // Haces cerrados: malla de flecha (nivel 0) con sus propias matrices y colores
+    struct BundleBuffers {
+        GLuint VAO = 0;
+        std::array<GLuint, 2> instanceVBOs{};      // 0: matriz, 1: color
+        std::array<InstanceUpload, 2> uploads{};
+        
+        void setup(const MeshBuffers& mesh);
+        void cleanup() noexcept;
+    };
+    bool edgeBundling = false;
+    EdgeBundler edgeBundler;
+    BundleBuffers bundleBuffers;
+    
+    // Máscaras de foco (1 = dentro, 0 = atenuado)
+    bool focusActive = false;
+    std::vector<uint8_t> sphereFocusMask;
+    std::vector<uint8_t> arrowFocusMask;
+    
     void setupSphereBuffers();
     void setupArrowBuffers();
     void updateSphereInstances(const Arcane& arcane);
     void updateArrowInstances(const Arcane& arcane);
+    void streamSpherePositions(const Arcane& arcane);
+    void streamArrowGeometry(const Arcane& arcane);
+    void compactInstances(const Arcane& arcane);
+    void uploadFocusMasks();
+    
+    // Colores (vec3) o estilos (modo paleta): por versiones si ids es nulo,
+    // si no compactados en el orden de ids
+    void uploadNodeColors(const Arcane& arcane, const uint32_t* ids, uint32_t count);
+    void uploadArrowColors(const Arcane& arcane, const uint32_t* ids, uint32_t count);
+    void setColorUniforms(const ProgramUniforms& program, const Arcane& arcane, float scale);
+    
+    // Culling, LOD o haces: instancias compactadas en los buffers estáticos
+    [[nodiscard]] bool compacting() const noexcept { return culling || levelOfDetail || edgeBundling; }
+    void compactionChanged(bool wasCompacting);
+    
+    // Atributos de instancia a partir de la instancia `first` de los buffers estáticos
+    void pointSphereInstances(uint32_t first);
+    void pointArrowInstances(uint32_t first);
+    
+    // Sube `count` instancias compactadas escritas por write(T* dst)
+    template<typename T, typename Writer>
+    void uploadCompacted(GLuint vbo, InstanceUpload& state, uint32_t count, Writer&& write);
+    
+    // Sube solo lo que cambió desde la última versión subida (nada si no cambió)
+    template<typename T, typename Writer>
+    void uploadInstances(GLuint vbo, InstanceUpload& state, const InstanceVersion& source,
+                         uint32_t count, Writer&& write);
+    // Fases del Profiler y tiempos de GPU de cada dibujo (solo con el Profiler activo)
+    enum GpuTimers : uint32_t { GPU_ARROWS, GPU_SPHERES, GPU_CULLING };
+    struct Phases {
+        uint32_t instances = 0;
+        uint32_t arrows = 0;
+        uint32_t spheres = 0;
+        uint32_t gpuArrows = 0;
+        uint32_t gpuSpheres = 0;
+        uint32_t gpuCulling = 0;
+    };
+    Phases phases;
+    GpuTimer gpuTimer;
+    
+    std::vector<unsigned char> uploadStaging;      // Memoria de paso, solo crece
+    uint64_t uploadedBytes = 0;                     // Bytes subidos en el último frame
     
     // Shaders como strings normales
-    static constexpr const char* ARROW_VERTEX_SHADER = R"(
-        #version 330 core
+    static constexpr const char* ARROW_VERTEX_BODY = R"(
         layout (location = 0) in vec3 aPos;
-        layout (location = 3) in vec3 instanceColor;
         layout (location = 4) in mat4 instanceMatrix;
 
         out vec3 fragColor;
@@ -59,7 +343,112 @@ private:
 
         void main() {
             gl_Position = projection * view * instanceMatrix * vec4(aPos, 1.0);
-            fragColor = instanceColor;
+            fragColor = instanceColor * mix(0.15, 1.0, instanceFocus);
+        }
+    )";
+    
+    // Los cuerpos de los vertex shaders se compilan con dos cabeceras:
+    // atributos de instancia (GL 3.3) o lectura de los SSBO por el id que dejó
+    // el culling en GPU (GL 4.3). Ambas definen instanceFocus, instancePos,
+    // instanceColor, instanceOrigin e instanceTarget; entre cabecera y cuerpo
+    // va PALETTE_COLORS.
+    static constexpr const char* INSTANCE_ATTRIBUTES = R"(
+        #version 330 core
+        layout (location = 1) in float instanceFocus;
+        layout (location = 2) in vec3 instancePos;
+        layout (location = 3) in vec3 instanceRgb;
+        layout (location = 8) in vec3 instanceOrigin;
+        layout (location = 9) in vec3 instanceTarget;
+        layout (location = 11) in uint instanceStyle;
+
+        #define instanceColor (paletteColors ? paletteColor(instanceStyle) : instanceRgb)
+    )";
+    
+    static constexpr const char* INSTANCE_STORAGE = R"(
+        #version 430 core
+        layout (location = 10) in uint instanceId;
+
+        // Datos completos de la red: posiciones de nodos o extremos de flechas
+        layout (std430, binding = 0) readonly buffer InstanceGeometry { float geometry[]; };
+        layout (std430, binding = 1) readonly buffer InstanceColors { float colors[]; };
+        layout (std430, binding = 2) readonly buffer InstanceFocus { uint focusMask[]; };     // 1 byte por instancia
+        layout (std430, binding = 5) readonly buffer InstanceStyles { uint styles[]; };
+        uniform bool focusActive;
+
+        vec3 geometryAt(uint i) { return vec3(geometry[3u * i], geometry[3u * i + 1u], geometry[3u * i + 2u]); }
+        vec3 colorAt(uint i) { return vec3(colors[3u * i], colors[3u * i + 1u], colors[3u * i + 2u]); }
+        float focusAt(uint i) {
+            if (!focusActive) return 1.0;
+            return float((focusMask[i >> 2u] >> ((i & 3u) * 8u)) & 0xFFu) / 255.0;
+        }
+
+        #define instanceFocus focusAt(instanceId)
+        #define instancePos geometryAt(instanceId)
+        #define instanceColor (paletteColors ? paletteColor(styles[instanceId]) : colorAt(instanceId))
+        #define instanceOrigin geometryAt(2u * instanceId)
+        #define instanceTarget geometryAt(2u * instanceId + 1u)
+    )";
+    
+    // Modo paleta: 64 = Arcane::PALETTE_SIZE, 0x10000 = InstanceStyle::HIGHLIGHTED
+    static constexpr const char* PALETTE_COLORS = R"(
+        uniform bool paletteColors;
+        uniform vec3 palette[64];
+        uniform float paletteScale;     // Arcane::ARROW_SHADE en las flechas
+        uniform vec3 highlightColor;
+
+        vec3 paletteColor(uint style) {
+            if ((style & 0x10000u) != 0u) return highlightColor;
+            return palette[min(style & 0xFFFFu, 63u)] * paletteScale;
+        }
+    )";
+    
+    // Misma composición que Arrow::updateTransform / ArrowKernel:
+    // traslación * rotación de arco mínimo Y -> dirección * escala * Rx(-90°)
+    static constexpr const char* ARROW_ENDPOINTS_VERTEX_BODY = R"(
+        layout (location = 0) in vec3 aPos;
+
+        out vec3 fragColor;
+
+        uniform mat4 view;
+        uniform mat4 projection;
+        uniform float sphereRadius;
+        uniform float thickness;
+
+        mat4 arrowMatrix(vec3 origin, vec3 target) {
+            vec3 d = target - origin;
+            float dist = length(d);
+            if (dist < 1e-5) return mat4(1.0);
+
+            vec3 n = d / dist;
+            float adjusted = dist - 2.0 * sphereRadius;
+            float len = abs(adjusted);
+            if (len < 1e-5) return mat4(1.0);
+
+            // Si las esferas se solapan la dirección se invierte
+            vec3 u = adjusted < 0.0 ? -n : n;
+
+            // Eje v = Y x u = (u.z, 0, -u.x), c = cos del ángulo
+            float s2 = u.x * u.x + u.z * u.z;
+            float c = 1.0;
+            vec2 v = vec2(0.0);
+            float h = 0.0;
+            if (s2 > 1e-12) {
+                c = u.y;
+                v = vec2(u.z, -u.x);
+                h = c >= 0.0 ? 1.0 / (1.0 + c) : (1.0 - c) / s2;
+            }
+            float hxz = h * v.x * v.y;
+
+            return mat4(
+                vec4(thickness * (c + h * v.x * v.x), thickness * v.y, thickness * hxz, 0.0),
+                vec4(-thickness * hxz, thickness * v.x, -thickness * (c + h * v.y * v.y), 0.0),
+                vec4(-len * v.y, len * c, len * v.x, 0.0),
+                vec4(origin + n * sphereRadius, 1.0));
+        }
+
+        void main() {
+            gl_Position = projection * view * arrowMatrix(instanceOrigin, instanceTarget) * vec4(aPos, 1.0);
+            fragColor = instanceColor * mix(0.15, 1.0, instanceFocus);
         }
     )";
     
@@ -73,11 +462,8 @@ private:
     )";
 
     // Añadir shaders para esferas
-    static constexpr const char* SPHERE_VERTEX_SHADER = R"(
-        #version 330 core
+    static constexpr const char* SPHERE_VERTEX_BODY = R"(
         layout (location = 0) in vec3 aPos;
-        layout (location = 2) in vec3 instancePos;
-        layout (location = 3) in vec3 instanceColor;
 
         uniform mat4 mvp;
         out vec3 vColor;
@@ -85,7 +471,7 @@ private:
         void main() {
             vec4 worldPos = vec4(aPos + instancePos, 1.0);
             gl_Position = mvp * worldPos;
-            vColor = instanceColor;
+            vColor = instanceColor * mix(0.15, 1.0, instanceFocus);
         }
     )";
 
@@ -97,4 +483,143 @@ private:
             FragColor = vec4(vColor, 1.0);
         }
     )";
+    
+    // Impostores: 4 vértices por instancia (triangle strip) generados a partir
+    // de gl_VertexID, sin atributo de posición. El quad es perpendicular al
+    // rayo cámara -> centro y su semilado es el radio del cono tangente a la
+    // esfera en ese plano, así que cubre exactamente la silueta proyectada.
+    static constexpr const char* SPHERE_IMPOSTOR_VERTEX_BODY = R"(
+        uniform mat4 view;
+        uniform mat4 projection;
+        uniform float radius;
+
+        out vec3 vColor;
+        out vec3 vViewPos;
+        flat out vec3 vCenter;
+
+        void main() {
+            vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+            vec3 center = (view * vec4(instancePos, 1.0)).xyz;
+            vColor = instanceColor * mix(0.15, 1.0, instanceFocus);
+            vCenter = center;
+
+            float d2 = dot(center, center);
+            float r2 = radius * radius;
+            if (d2 <= r2) {
+                // Cámara dentro de la esfera: quad fuera del volumen de recorte
+                vViewPos = center;
+                gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+                return;
+            }
+
+            vec3 dir = center * inversesqrt(d2);
+            vec3 ref = abs(dir.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+            vec3 right = normalize(cross(ref, dir));
+            vec3 up = cross(dir, right);
+            float halfSize = radius * sqrt(d2 / (d2 - r2));
+
+            vViewPos = center + (right * corner.x + up * corner.y) * halfSize;
+            gl_Position = projection * vec4(vViewPos, 1.0);
+        }
+    )";
+    
+    // Intersección rayo-esfera en espacio de vista; la profundidad escrita es
+    // la del punto de impacto, así que las esferas se cortan correctamente
+    // entre sí y con las flechas
+    static constexpr const char* SPHERE_IMPOSTOR_FRAGMENT_SHADER = R"(
+        #version 330 core
+        in vec3 vColor;
+        in vec3 vViewPos;
+        flat in vec3 vCenter;
+
+        uniform mat4 projection;
+        uniform float radius;
+
+        out vec4 FragColor;
+
+        void main() {
+            vec3 dir = normalize(vViewPos);
+            float b = dot(dir, vCenter);
+            float disc = b * b - (dot(vCenter, vCenter) - radius * radius);
+            if (disc < 0.0) discard;
+
+            vec3 hit = dir * (b - sqrt(disc));
+            vec4 clip = projection * vec4(hit, 1.0);
+            float ndcDepth = clip.z / clip.w;
+            gl_FragDepth = (gl_DepthRange.diff * ndcDepth + gl_DepthRange.near + gl_DepthRange.far) * 0.5;
+            FragColor = vec4(vColor, 1.0);
+        }
+    )";
+    
+    // Culling por frustum y nivel de detalle de una instancia por invocación:
+    // mismas esferas envolventes, planos y umbrales que el camino de CPU. Cada
+    // instancia visible reserva su hueco con un atomicAdd sobre el
+    // instanceCount del comando de su nivel.
+    static constexpr const char* CULL_COMPUTE_SHADER = R"(
+        #version 430 core
+        layout (local_size_x = 64) in;
+
+        layout (std430, binding = 0) readonly buffer InstanceGeometry { float geometry[]; };
+        layout (std430, binding = 3) writeonly buffer VisibleIds { uint visibleIds[]; };
+        layout (std430, binding = 4) buffer DrawCommands { uint commands[]; };
+
+        uniform mat4 viewProjection;
+        uniform vec3 depthAxis;         // Profundidad en espacio de vista = dot(depthAxis, p) + depthOffset
+        uniform float depthOffset;
+        uniform float focal;            // Píxeles por unidad a profundidad 1
+        uniform float radius;           // Nodo, o radio de la punta de la flecha
+        uniform vec3 thresholds;        // Radio proyectado mínimo de cada nivel
+        uniform int levels;             // Umbrales usados (0 = todo al nivel 0)
+        uniform int count;
+        uniform int capacity;           // Ids reservados por nivel
+        uniform int commandBase;        // Primera palabra del comando del nivel 0
+        uniform bool arrows;
+        uniform bool culling;
+
+        vec3 geometryAt(uint i) { return vec3(geometry[3u * i], geometry[3u * i + 1u], geometry[3u * i + 2u]); }
+
+        // Planos de Gribb-Hartmann normalizados (ver Frustum::fromMatrix)
+        bool outside(vec3 center, float bound) {
+            vec4 w = vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+            for (int axis = 0; axis < 3; ++axis) {
+                vec4 row = vec4(viewProjection[0][axis], viewProjection[1][axis],
+                                viewProjection[2][axis], viewProjection[3][axis]);
+                for (int side = 0; side < 2; ++side) {
+                    vec4 plane = side == 0 ? w + row : w - row;
+                    float len = length(plane.xyz);
+                    if (len > 0.0 && dot(plane.xyz, center) + plane.w < -bound * len) return true;
+                }
+            }
+            return false;
+        }
+
+        void main() {
+            uint i = gl_GlobalInvocationID.x;
+            if (i >= uint(count)) return;
+
+            vec3 center;
+            float bound;
+            float depth;
+            if (arrows) {
+                // Esfera en el punto medio; LOD por el extremo más cercano
+                vec3 o = geometryAt(2u * i);
+                vec3 d = geometryAt(2u * i + 1u);
+                center = (o + d) * 0.5;
+                bound = length(d - o) * 0.5 + radius;
+                depth = min(dot(depthAxis, o), dot(depthAxis, d)) + depthOffset;
+            } else {
+                center = geometryAt(i);
+                bound = radius;
+                depth = dot(depthAxis, center) + depthOffset;
+            }
+            if (culling && outside(center, bound)) return;
+
+            float pixels = radius * focal / max(depth, 1e-3);
+            int level = 0;
+            while (level < levels && pixels < thresholds[level]) ++level;
+
+            uint slot = atomicAdd(commands[commandBase + level * 5 + 1], 1u);
+            visibleIds[uint(level * capacity) + slot] = i;
+        }
+    )";
 };
\ No newline at end of file
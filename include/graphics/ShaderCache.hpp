@@ -0,0 +1,48 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Caché en disco de binarios de programas (glGetProgramBinary / glProgramBinary).
+// La clave es un hash de las fuentes más GL_VENDOR, GL_RENDERER y GL_VERSION,
+// así que un cambio de shader o de driver produce otra clave. Un binario que
+// el driver rechaza se borra y el llamador compila desde las fuentes.
+// Directorio: %LOCALAPPDATA%\Multiverso\shaders en Windows,
+// $XDG_CACHE_HOME/multiverso/shaders (o ~/.cache/...) en el resto.
+class ShaderCache {
+public:
+    ShaderCache();                                      // Directorio por defecto
+    explicit ShaderCache(std::filesystem::path directory);
+    
+    // Requiere GL 4.1 o ARB_get_program_binary y al menos un formato binario
+    [[nodiscard]] bool enabled() const noexcept { return _enabled; }
+    [[nodiscard]] const std::filesystem::path& directory() const noexcept { return _directory; }
+    
+    [[nodiscard]] uint64_t key(std::string_view vertexSrc, std::string_view fragmentSrc) const noexcept;
+    
+    // Carga el binario en `program` (creado con glCreateProgram). false si no
+    // existe o el driver no lo acepta; el programa queda sin enlazar.
+    bool load(uint64_t key, GLuint program);
+    
+    // Guarda el binario de un programa enlazado con PROGRAM_BINARY_RETRIEVABLE_HINT
+    void store(uint64_t key, GLuint program);
+    
+    // Marca el programa como recuperable; llamar antes de glLinkProgram
+    void prepare(GLuint program) const noexcept;
+    
+    [[nodiscard]] uint32_t hits() const noexcept { return _hits; }
+    [[nodiscard]] uint32_t misses() const noexcept { return _misses; }
+    
+    [[nodiscard]] static std::filesystem::path defaultDirectory();
+    
+private:
+    std::filesystem::path _directory;
+    uint64_t _driverHash = 0;               // Vendor, renderer y versión
+    bool _enabled = false;
+    uint32_t _hits = 0;
+    uint32_t _misses = 0;
+    
+    [[nodiscard]] std::filesystem::path pathFor(uint64_t key) const;
+};
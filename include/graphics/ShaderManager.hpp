@@ -1,20 +1,42 @@
 #pragma once
 #include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <string_view>
+#include <vector>
 #include <optional> // Usar std::optional en lugar de std::expected
 
+// Programas identificados por handle (índice) y uniforms reflejados con
+// glGetActiveUniform al enlazar. Los nombres solo se buscan al inicializar;
+// en el frame se usan handles y los setters tipados no llaman al driver si el
+// valor no cambió.
+class ShaderCache;
+
 class ShaderManager {
 public:
-    ShaderManager() = default;
-    ~ShaderManager() { cleanup(); }
+    ShaderManager();
+    ~ShaderManager();
+    
+    struct ProgramHandle {
+        uint32_t index = UINT32_MAX;
+        [[nodiscard]] bool valid() const noexcept { return index != UINT32_MAX; }
+    };
+    
+    struct UniformHandle {
+        uint32_t index = UINT32_MAX;        // En la tabla global de uniforms
+        [[nodiscard]] bool valid() const noexcept { return index != UINT32_MAX; }
+    };
     
     // Reemplazar std::expected con std::optional + string de error
     struct ShaderResult {
         bool success;
         GLuint programId;
         std::string errorMessage;
+        ProgramHandle handle{};
     };
     
     ShaderResult loadShaderProgram(
@@ -22,19 +44,84 @@ public:
         std::string_view vertexSrc, 
         std::string_view fragmentSrc);
     
+    // Con computeSrc el programa es de cómputo y las otras dos fuentes se ignoran
+    struct ProgramSource {
+        std::string_view name;
+        std::string_view vertexSrc;
+        std::string_view fragmentSrc;
+        std::string_view computeSrc{};
+    };
+    
+    // Carga varios programas de una vez: los que están en la caché de binarios
+    // se restauran directamente; para el resto se lanzan todas las
+    // compilaciones y enlaces antes de consultar ningún estado, de modo que
+    // con KHR_parallel_shader_compile el driver los compila en paralelo.
+    // Un resultado por fuente, en el mismo orden.
+    std::vector<ShaderResult> loadShaderPrograms(std::span<const ProgramSource> sources);
+    
+    // Nullptr hasta la primera carga (necesita un contexto GL)
+    [[nodiscard]] const ShaderCache* cache() const noexcept { return _cache.get(); }
+    
+    // Búsquedas por nombre: solo al inicializar
+    [[nodiscard]] ProgramHandle findProgram(std::string_view name) const;
+    [[nodiscard]] UniformHandle findUniform(ProgramHandle program, std::string_view name) const;
     [[nodiscard]] GLuint getShaderProgram(std::string_view name) const;
-    void useShader(std::string_view name) const;
+    
+    [[nodiscard]] GLuint getProgramId(ProgramHandle program) const noexcept;
+    
+    // glUseProgram solo si cambia el programa activo
+    void use(ProgramHandle program);
+    
+    // Activan el programa del uniform si hace falta. Un handle inválido (uniform
+    // eliminado por el compilador) se ignora.
+    void setUniform(UniformHandle uniform, int value);
+    void setUniform(UniformHandle uniform, float value);
+    void setUniform(UniformHandle uniform, const glm::vec3& value);
+    void setUniform(UniformHandle uniform, const glm::vec4& value);
+    void setUniform(UniformHandle uniform, const glm::mat4& value);
+    void setUniform(UniformHandle uniform, const glm::vec3* values, uint32_t count);
+    
+    // Llamadas a glUniform* y a glUseProgram hechas / evitadas por la caché
+    [[nodiscard]] uint64_t uniformUploads() const noexcept { return _uploads; }
+    [[nodiscard]] uint64_t uniformSkips() const noexcept { return _skips; }
+    
+    // Olvida el programa activo (tras un glUseProgram externo, p. ej. ImGui)
+    void invalidateCurrent() noexcept { _current = UINT32_MAX; }
+    
     void cleanup();
     
 private:
-    std::unordered_map<std::string, GLuint> shaderPrograms;
+    struct Uniform {
+        GLint location = -1;
+        GLenum type = 0;
+        uint32_t program = 0;       // Índice en _programs
+        uint32_t offset = 0;        // Primera palabra en _values
+        uint32_t words = 0;         // Palabras de 32 bits (componentes * tamaño del array)
+        bool initialized = false;   // Sin valor conocido hasta el primer set
+    };
     
-    struct CompileResult {
-        bool success;
-        GLuint shaderId;
-        std::string errorMessage;
+    struct Program {
+        GLuint id = 0;
+        std::string name;
+        std::unordered_map<std::string, uint32_t> uniforms;    // Nombre -> índice en _uniforms
     };
     
-    [[nodiscard]] CompileResult compileShader(GLenum type, std::string_view source);
-    [[nodiscard]] ShaderResult linkProgram(GLuint vertexShader, GLuint fragmentShader);
-};
\ No newline at end of file
+    std::unordered_map<std::string, uint32_t> shaderPrograms;     // Nombre -> índice en _programs
+    std::vector<Program> _programs;
+    std::vector<Uniform> _uniforms;
+    std::vector<uint32_t> _values;          // Último valor subido de cada uniform
+    std::unique_ptr<ShaderCache> _cache;
+    uint32_t _current = UINT32_MAX;
+    uint64_t _uploads = 0;
+    uint64_t _skips = 0;
+    
+    // Lanza la compilación sin esperar al resultado
+    [[nodiscard]] static GLuint compileShader(GLenum type, std::string_view source);
+    // Log de compilación si falló
+    [[nodiscard]] static std::optional<std::string> shaderError(GLuint shader);
+    ProgramHandle registerProgram(std::string_view name, GLuint id);
+    void reflectUniforms(uint32_t program);
+    
+    // Compara con la caché y la actualiza; true si hay que subir el valor
+    [[nodiscard]] bool changed(UniformHandle uniform, const void* value, uint32_t words);
+};
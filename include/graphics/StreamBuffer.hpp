@@ -0,0 +1,49 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+
+// Buffer de vértices para datos que cambian cada frame, dividido en un anillo
+// de tres regiones: la CPU escribe en una mientras la GPU lee las otras.
+// Cada región se protege con un fence que se espera antes de reescribirla.
+// - Con ARB_buffer_storage: almacenamiento inmutable mapeado de forma
+//   persistente y coherente; map() devuelve un puntero ya mapeado.
+// - Sin él: glMapBufferRange con UNSYNCHRONIZED | INVALIDATE_RANGE por frame.
+class StreamBuffer {
+public:
+    static constexpr uint32_t REGIONS = 3;
+
+    StreamBuffer() = default;
+    ~StreamBuffer() { destroy(); }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Garantiza regiones de al menos `regionBytes` (recrea el buffer si no caben)
+    void reserve(GLsizeiptr regionBytes);
+
+    // Avanza a la siguiente región y la devuelve lista para escribir
+    [[nodiscard]] void* map();
+    // Cierra la escritura; devuelve el offset en bytes de la región dentro del buffer
+    GLintptr unmap();
+    // Tras emitir los draws que leen la región actual
+    void fence();
+
+    void destroy() noexcept;
+
+    [[nodiscard]] GLuint id() const noexcept { return _buffer; }
+    [[nodiscard]] bool persistent() const noexcept { return _persistent; }
+    [[nodiscard]] GLsizeiptr regionSize() const noexcept { return _regionSize; }
+
+    // Mapeo persistente disponible en el contexto actual
+    [[nodiscard]] static bool persistentSupported() noexcept;
+
+private:
+    GLuint _buffer = 0;
+    GLsizeiptr _regionSize = 0;
+    uint32_t _region = REGIONS - 1;
+    unsigned char* _persistentPtr = nullptr;
+    bool _persistent = false;
+    GLsync _fences[REGIONS] = {};
+
+    void waitRegion(uint32_t region);
+};
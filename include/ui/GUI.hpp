@@ -1,20 +1,78 @@
 #pragma once
 #include "imgui.h"
 #include <GLFW/glfw3.h> // ¡FALTABA ESTE HEADER!
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 class Arcane;
 
+// Los widgets se construyen en el hilo de UI (beginFrame, render, endFrame);
+// el backend OpenGL vive en el hilo de render, que dibuja una copia de las
+// listas de ImGui (DrawDataCopy) tomada al cerrar el frame.
 class GUI {
 public:
+    // Hilo de UI: contexto de ImGui y backend GLFW
     void initialize(GLFWwindow* window);
     void beginFrame();
-    void render(Arcane& arcane);
-    void endFrame();
+    void render(const Arcane& arcane);
+    
+    // Copia de ImDrawData que sobrevive al siguiente frame de ImGui. Las
+    // listas y sus buffers se reutilizan: en estado estable no reserva memoria.
+    class DrawDataCopy {
+    public:
+        void capture(const ImDrawData* source);
+        [[nodiscard]] bool valid() const noexcept { return data.Valid; }
+        
+    private:
+        friend class GUI;
+        ImDrawData data;
+        std::vector<std::unique_ptr<ImDrawList>> lists;
+    };
+    
+    // Hilo de render (contexto GL actual)
+    void initializeRenderer();
+    void renderDrawData(DrawDataCopy& drawData);
+    void cleanupRenderer();
+    
+    // Estadísticas del frame anterior mostradas en "Control de Nodos"
+    struct FrameStats {
+        uint64_t allocations = 0;
+        uint64_t uploadedBytes = 0;
+        bool culling = false;
+        double cullMilliseconds = 0.0;
+        uint32_t visibleNodes = 0;
+        uint32_t totalNodes = 0;
+        uint32_t visibleArrows = 0;
+        uint32_t totalArrows = 0;
+        bool levelOfDetail = false;
+        std::array<uint32_t, 4> nodeLevels{};       // Instancias por nivel de detalle
+        std::array<uint32_t, 4> arrowLevels{};      // El último nivel de flechas son líneas
+        uint32_t bundles = 0;                       // Haces cerrados dibujados
+        uint32_t bundledArrows = 0;                 // Flechas que representan
+        uint32_t layoutIteration = 0;               // Layout de fuerzas (hilo de UI)
+        float layoutTemperature = 0.0f;
+        bool layoutConverged = false;
+        uint64_t triangles = 0;
+        uint32_t drawCalls = 0;
+        uint32_t drawnNodes = 0;
+        uint32_t drawnArrows = 0;
+    };
+    void setFrameStats(const FrameStats& stats) noexcept { frameStats = stats; }
+    // Cierra el frame de ImGui; los datos valen hasta el próximo beginFrame
+    [[nodiscard]] const ImDrawData* endFrame();
     void cleanup();
     
     // Getters con C++20
+    // Nodo elegido con el ratón: 0 = origen, 1 = destino
+    void setSelectedNode(int slot, int id) noexcept {
+        (slot == 0 ? selectedNode1 : selectedNode2) = id;
+    }
+    // Nodo bajo el cursor (-1 = ninguno); muestra sus cotas de distancia desde el origen
+    void setHoveredNode(int id) noexcept { hoveredNode = id; }
     [[nodiscard]] std::pair<int, int> getSelectedNodes() const noexcept { 
         return {selectedNode1, selectedNode2}; 
     }
@@ -26,15 +84,102 @@ public:
     [[nodiscard]] bool isPathFindingRequested() const noexcept { 
         return pathFindingRequested; 
     }
+    [[nodiscard]] bool isALTEnabled() const noexcept {
+        return useALT;
+    }
+    // Flechas construidas en el vertex shader a partir de sus extremos
+    [[nodiscard]] bool isGpuArrowsEnabled() const noexcept {
+        return gpuArrows;
+    }
+    // Buffers de instancias en anillo, escritos cada frame (layouts animados)
+    [[nodiscard]] bool isStreamingEnabled() const noexcept {
+        return streamingBuffers;
+    }
+    // Nodos como quads con la esfera trazada en el fragment shader
+    [[nodiscard]] bool isImpostorsEnabled() const noexcept {
+        return sphereImpostors;
+    }
+    // Mallas según el tamaño en pantalla (flechas lejanas como líneas)
+    [[nodiscard]] bool isLevelOfDetailEnabled() const noexcept {
+        return levelOfDetail;
+    }
+    // Culling y LOD en un compute shader (GL 4.3) en vez de en la CPU
+    [[nodiscard]] bool isGpuCullingEnabled() const noexcept {
+        return gpuCulling;
+    }
+    // Colores por índice en la paleta de niveles en vez de vec3 por instancia
+    [[nodiscard]] bool isPaletteColorsEnabled() const noexcept {
+        return paletteColors;
+    }
+    // Flechas lejanas agrupadas por celdas de origen y destino
+    [[nodiscard]] bool isEdgeBundlingEnabled() const noexcept {
+        return edgeBundling;
+    }
+    // Layout de fuerzas (Barnes-Hut) en vez de las capas de Fibonacci
+    [[nodiscard]] bool isForceLayoutEnabled() const noexcept {
+        return forceLayout;
+    }
+    // Perfilador de fases (CPU y GPU) con su panel
+    [[nodiscard]] bool isProfilerEnabled() const noexcept {
+        return profilerEnabled;
+    }
+    // Culling por frustum de nodos y flechas
+    [[nodiscard]] bool isCullingEnabled() const noexcept {
+        return frustumCulling;
+    }
+    // Vecindad del nodo origen: (saltos, dirección 0 = salida, 1 = entrada, 2 = ambas)
+    [[nodiscard]] std::optional<std::pair<int, int>> getNeighborhoodRequest() const noexcept {
+        if (neighborhoodRequested)
+            return {{neighborhoodHops, neighborhoodDirection}};
+        return std::nullopt;
+    }
+    [[nodiscard]] bool isFocusClearRequested() const noexcept {
+        return focusClearRequested;
+    }
+    // Métrica: 0 = nivel, 1 = intermediación, 2 = cercanía. Pivotes: 0 = exacto
+    [[nodiscard]] std::optional<std::pair<int, int>> getMetricRequest() const noexcept {
+        if (metricRequested)
+            return {{selectedMetric, metricSamples}};
+        return std::nullopt;
+    }
     
 private:
     int selectedNode1 = 0;
     int selectedNode2 = 1;
+    int hoveredNode = -1;
     bool regenerateRequested = false;
     bool pathFindingRequested = false;
+    bool useALT = true;
+    bool gpuArrows = false;
+    bool streamingBuffers = false;
+    bool frustumCulling = false;
+    bool sphereImpostors = true;
+    bool levelOfDetail = false;
+    bool gpuCulling = false;
+    bool paletteColors = false;
+    bool edgeBundling = false;
+    bool forceLayout = false;
+    bool profilerEnabled = false;
     int newNodeCount = 36;
     int newInitialNodes = 2;
+    bool metricRequested = false;
+    int selectedMetric = 0;
+    int metricSamples = 0;
+    bool neighborhoodRequested = false;
+    bool focusClearRequested = false;
+    int neighborhoodHops = 3;
+    int neighborhoodDirection = 2;
+    FrameStats frameStats;
+    float columnBottom = 0.0f;          // Borde inferior de la última ventana de la columna izquierda
     
+    // Ventanas fijas de la columna izquierda: ancho dado, alto según el
+    // contenido, y cada una debajo de la anterior
+    void beginColumnWindow(const char* name, float width);
+    void endColumnWindow();
     void renderNetworkControls();
-    void renderPathFindingControls();
+    void renderPathFindingControls(const Arcane& arcane);
+    void renderDistanceBounds(const Arcane& arcane, int from, int to);
+    void renderHoverTooltip(const Arcane& arcane);
+    void renderAnalysisControls();
+    void renderProfiler();
 };
\ No newline at end of file
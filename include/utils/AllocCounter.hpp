@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// Contador global de asignaciones dinámicas. AllocCounter.cpp reemplaza los
+// operator new/delete globales y cuenta cada asignación con un atómico
+// relajado, de modo que el coste es despreciable y se puede dejar activo.
+// Uso: tomar dos instantáneas y restarlas (p.ej. asignaciones por frame).
+namespace AllocCounter {
+    struct Snapshot {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    [[nodiscard]] Snapshot snapshot() noexcept;
+
+    [[nodiscard]] inline Snapshot since(const Snapshot& start) noexcept {
+        Snapshot now = snapshot();
+        return {now.allocations - start.allocations, now.bytes - start.bytes};
+    }
+}
@@ -9,6 +9,8 @@ public:
     void handleMouseMovement(double xpos, double ypos, bool mousePressed) noexcept;
     void handleScroll(double yoffset) noexcept;
     void update() noexcept { /* ... */ }
+    // Posición directa (recorridos guionizados del modo headless); mismos límites que el input
+    void setOrbit(float yawDegrees, float pitchDegrees, float distance) noexcept;
     
     [[nodiscard]] glm::mat4 getViewMatrix() const noexcept;
     [[nodiscard]] float getRadius() const noexcept { return radius; }
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Modo sin ventana para benchmarks: contexto EGL surfaceless (Mesa llvmpipe
+// sirve), render a un FBO sin VSync y una órbita de cámara fija recorrida en
+// N frames. Informa tiempos de CPU y GPU por frame (resumen y CSV opcional)
+// y puede volcar PNG para regresión visual. Requiere la opción de CMake
+// MULTIVERSO_HEADLESS (enlaza EGL); sin ella run() solo informa del error.
+//
+//   Multiverso --headless [--nodes N] [--initial N] [--frames N] [--warmup N]
+//              [--size WxH] [--csv archivo] [--png directorio] [--png-every N]
+//              [--culling] [--lod] [--gpu-culling] [--palette] [--mesh] [--gpu-arrows]
+//              [--bundles] [--layout]
+class Headless {
+public:
+    struct Options {
+        uint32_t nodes = 5000;
+        uint32_t initialNodes = 2;
+        uint32_t frames = 600;
+        uint32_t warmup = 10;           // Frames previos fuera de las estadísticas
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        std::string csvPath;
+        std::string pngDirectory;
+        uint32_t pngEvery = 0;          // 0 = solo el primer frame si hay directorio
+        bool culling = false;
+        bool levelOfDetail = false;
+        bool gpuCulling = false;        // Culling y LOD en compute shader (GL 4.3)
+        bool paletteColors = false;
+        bool sphereMesh = false;
+        bool gpuArrows = false;
+        bool edgeBundling = false;
+        bool forceLayout = false;       // Layout de fuerzas con la rebanada por frame por defecto
+    };
+
+    [[nodiscard]] static bool requested(int argc, char** argv) noexcept;
+
+    // Código de salida del proceso
+    static int run(int argc, char** argv);
+};
@@ -2,6 +2,10 @@
 #include <glm/glm.hpp>
 #include <random>
 #include <concepts>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
 
 namespace MathUtils {
     // Conceptos C++20
@@ -25,6 +29,13 @@ namespace MathUtils {
         else return {c + m, m, x + m};
     }
     
+    // Gradiente frío-caliente para métricas normalizadas en [0, 1] (azul -> rojo)
+    [[nodiscard]] static glm::vec3 metricToColor(float t) {
+        t = std::clamp(t, 0.0f, 1.0f);
+        float hue = (1.0f - t) * (4.0f / 6.0f);
+        return levelToColor(hue * 6.0f, 5.0f, 0.9f, 1.0f);
+    }
+    
     // Distribución uniforme con concept
     template<Arithmetic T>
     [[nodiscard]] static T randomRange(T min, T max) {
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// PNG RGBA de 8 bits sin dependencias: los datos van en bloques deflate sin
+// comprimir (tipo 0), así que el archivo ocupa ~4 bytes por píxel. Basta para
+// volcados de regresión visual; cualquier visor o diff de imágenes lo lee.
+class PngWriter {
+public:
+    // `rgba` tiene width * height * 4 bytes por filas. `flipVertically` para
+    // datos de glReadPixels (primera fila abajo).
+    static bool write(const std::string& path, uint32_t width, uint32_t height,
+                      const uint8_t* rgba, bool flipVertically = false);
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Perfilador de fases por frame. Cada fase acumula los milisegundos medidos
+// durante el frame (Scope o record) y endFrame() los guarda en un historial
+// circular de HISTORY frames, del que la GUI dibuja gráficas y percentiles.
+// Las fases de GPU se registran igual, con el resultado de GpuTimer (un
+// frame de retraso). Desactivado, un Scope solo comprueba un bool y no lee
+// el reloj. Los hilos de UI y de render graban a la vez: record/endFrame
+// toman un mutex (pocas llamadas por frame) y quien lee el historial lo
+// hace bajo lock(). endFrame lo llama el hilo de render.
+class Profiler {
+public:
+    static constexpr uint32_t HISTORY = 240;
+    static constexpr uint32_t MAX_PHASES = 16;
+    static constexpr uint32_t INVALID_PHASE = UINT32_MAX;
+
+    [[nodiscard]] static Profiler& instance();
+
+    // Registra una fase (o devuelve la existente). Al inicializar, no en el frame.
+    uint32_t phase(std::string_view name);
+
+    void setEnabled(bool enabled) noexcept;
+    [[nodiscard]] bool enabled() const noexcept { return _enabled.load(std::memory_order_relaxed); }
+
+    // Suma `milliseconds` a la fase en el frame actual
+    void record(uint32_t phase, double milliseconds) noexcept;
+    void endFrame() noexcept;
+
+    // ----- Consulta (GUI), con lock() tomado -----
+    [[nodiscard]] std::unique_lock<std::mutex> lock() const { return std::unique_lock<std::mutex>(_mutex); }
+    [[nodiscard]] uint32_t phaseCount() const noexcept { return static_cast<uint32_t>(_names.size()); }
+    [[nodiscard]] const char* name(uint32_t phase) const noexcept { return _names[phase].c_str(); }
+    // Historial circular: `frames()` valores válidos, el más antiguo en `historyOffset()`
+    [[nodiscard]] const float* history(uint32_t phase) const noexcept { return _history[phase].data(); }
+    [[nodiscard]] uint32_t historyOffset() const noexcept { return _frames < HISTORY ? 0 : _head; }
+    [[nodiscard]] uint32_t frames() const noexcept { return _frames; }
+    [[nodiscard]] float last(uint32_t phase) const noexcept;
+    // p en [0, 1] sobre el historial válido
+    [[nodiscard]] float percentile(uint32_t phase, float p) const noexcept;
+
+    class Scope {
+    public:
+        explicit Scope(uint32_t phase) noexcept;
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        uint32_t _phase;
+        bool _active;
+        Clock::time_point _start;
+    };
+
+private:
+    std::atomic<bool> _enabled{false};
+    mutable std::mutex _mutex;
+    std::vector<std::string> _names;
+    std::array<double, MAX_PHASES> _current{};
+    std::array<std::array<float, HISTORY>, MAX_PHASES> _history{};
+    uint32_t _head = 0;             // Siguiente frame a escribir
+    uint32_t _frames = 0;           // Frames válidos (hasta HISTORY)
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Pool de hilos persistente para bucles paralelos por bloques.
+// Los hilos se crean una sola vez; cada parallelFor reparte el rango [0, count)
+// en bloques de tamaño `grain` que los hilos (incluido el llamador) consumen
+// con un contador atómico. Despachar un trabajo no reserva memoria.
+class ThreadPool {
+public:
+    // Tarea: (contexto, hilo, inicio, fin)
+    using Task = void (*)(void*, uint32_t, uint32_t, uint32_t);
+
+    explicit ThreadPool(uint32_t workers = 0);      // 0 = hardware_concurrency - 1
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] static ThreadPool& instance();
+
+    // Número de hilos que pueden ejecutar un bloque (trabajadores + llamador)
+    [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(_workers.size()) + 1; }
+
+    // fn(uint32_t hilo, uint32_t inicio, uint32_t fin). `hilo` está en [0, size())
+    // y sirve para indexar acumuladores por hilo.
+    template<typename Fn>
+    void parallelFor(uint32_t count, uint32_t grain, Fn&& fn) {
+        auto trampoline = [](void* ctx, uint32_t worker, uint32_t begin, uint32_t end) {
+            (*static_cast<std::remove_reference_t<Fn>*>(ctx))(worker, begin, end);
+        };
+        run(count, grain, static_cast<void*>(&fn), trampoline);
+    }
+
+private:
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::mutex _dispatchMutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    // ----- Trabajo actual -----
+    Task _task = nullptr;
+    void* _context = nullptr;
+    uint32_t _count = 0;
+    uint32_t _grain = 1;
+    std::atomic<uint32_t> _next{0};
+    uint32_t _active = 0;
+    uint64_t _generation = 0;
+    bool _stop = false;
+
+    void run(uint32_t count, uint32_t grain, void* context, Task task);
+    void workerLoop(uint32_t index);
+    void drain(uint32_t worker);
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Eventos begin/end exportados como JSON de Chrome trace-event (se abre en
+// ui.perfetto.dev o chrome://tracing). Cada hilo guarda sus scopes cerrados
+// (inicio y duración, así que siempre van emparejados) en un anillo propio de
+// capacidad fija que sobrescribe los más antiguos: la exportación tiene los
+// últimos segundos, no los del arranque. Sin bloqueos al grabar; el mutex
+// solo se toma al registrar un hilo y al exportar, que lee el anillo mientras
+// se escribe (cada hueco lleva una secuencia y los sobrescritos a medias se
+// descartan). Los nombres deben ser literales (se guarda el puntero).
+//
+// Dos interruptores: la opción de CMake MULTIVERSO_TRACE compila las macros
+// (sin ella no generan código) y setEnabled() graba o no en tiempo de
+// ejecución (la variable de entorno MULTIVERSO_TRACE=1 lo activa al inicio).
+class Trace {
+public:
+#ifdef MULTIVERSO_TRACE
+    static constexpr bool COMPILED = true;
+#else
+    static constexpr bool COMPILED = false;
+#endif
+    // Scopes cerrados por hilo; al llenarse se sobrescriben los más antiguos
+    static constexpr uint32_t CAPACITY = 1u << 16;
+    // Scopes abiertos a la vez por hilo; los más profundos no se graban
+    static constexpr uint32_t MAX_DEPTH = 64;
+
+    [[nodiscard]] static bool enabled() noexcept { return _enabled.load(std::memory_order_relaxed); }
+    // Al reanudar se olvida lo grabado antes de la pausa
+    static void setEnabled(bool enabled);
+
+    // Nombre del hilo actual en el visor (p. ej. "Principal", "Pool 3")
+    static void setThreadName(std::string_view name);
+
+    // begin devuelve false si no se grabó; en ese caso no hay que llamar a end
+    static bool begin(const char* category, const char* name) noexcept;
+    static void end() noexcept;
+
+    // Escribe lo que conservan los anillos (los últimos CAPACITY scopes por hilo)
+    static bool write(const std::string& path);
+    static void clear();
+    [[nodiscard]] static uint64_t eventCount();
+    [[nodiscard]] static uint64_t dropped();           // Sobrescritos o demasiado profundos
+
+    class Scope {
+    public:
+        Scope(const char* category, const char* name) noexcept
+            : _active(Trace::enabled() && Trace::begin(category, name)) {}
+        ~Scope() { if (_active) Trace::end(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool _active;
+    };
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+#define MULTIVERSO_TRACE_CONCAT_(a, b) a##b
+#define MULTIVERSO_TRACE_CONCAT(a, b) MULTIVERSO_TRACE_CONCAT_(a, b)
+
+#ifdef MULTIVERSO_TRACE
+#define MULTIVERSO_TRACE_SCOPE(category, name) \
+    Trace::Scope MULTIVERSO_TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#else
+#define MULTIVERSO_TRACE_SCOPE(category, name) ((void)0)
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Triple buffer sin bloqueos para un productor y un consumidor. El productor
+// escribe en back() y publica; el consumidor toma con update() el último
+// valor publicado y lo lee en front(). Los valores intermedios se descartan:
+// sirve para estado completo por frame, no para colas de comandos.
+// Los tres slots se reutilizan, así que sus buffers internos no se
+// vuelven a reservar; el productor debe reescribir todo el contenido.
+template <typename T>
+class TripleBuffer {
+public:
+    // ----- Productor -----
+    [[nodiscard]] T& back() noexcept { return _buffers[_back]; }
+
+    void publish() noexcept {
+        const uint8_t previous = _middle.exchange(_back | FRESH, std::memory_order_acq_rel);
+        _back = previous & INDEX;
+    }
+
+    // ----- Consumidor -----
+    // true si había un valor nuevo; si no, front() sigue siendo el anterior
+    bool update() noexcept {
+        if (!(_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+        _front = previous & INDEX;
+        return true;
+    }
+
+    [[nodiscard]] T& front() noexcept { return _buffers[_front]; }
+    [[nodiscard]] const T& front() const noexcept { return _buffers[_front]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;      // El slot intermedio aún no se consumió
+
+    std::array<T, 3> _buffers{};
+    std::atomic<uint8_t> _middle{1};
+    uint8_t _front = 0;                         // Solo el consumidor
+    uint8_t _back = 2;                          // Solo el productor
+};
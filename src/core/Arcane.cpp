@@ -1,8 +1,12 @@
 #include "core/Arcane.hpp"
+#include "core/ArrowKernel.hpp"
 #include "utils/MathUtils.hpp"
+#include "utils/ThreadPool.hpp"
+#include "utils/Trace.hpp"
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 
 
 
@@ -13,6 +17,21 @@
 // #include <ranges>
 // #include <unordered_map>
 
+namespace {
+    // Landmarks precalculados al generar la red (2 BFS por landmark)
+    constexpr uint32_t DEFAULT_LANDMARKS = 8;
+
+    // Elementos por bloque en las escrituras paralelas de datos de instancia
+    constexpr uint32_t WRITE_GRAIN = 16384;
+
+    // Versiones únicas entre todas las redes: una red regenerada nunca
+    // coincide con entradas de caché de la anterior
+    std::atomic<uint64_t> versionCounter{0};
+}
+
+uint64_t Arcane::nextVersion() noexcept {
+    return versionCounter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
 
 Arcane::Arcane(){
     std::random_device rd;
@@ -25,6 +44,9 @@ Arcane::Arcane(){
     assignLevelColors();
     generateArrows();
     assignArrowColors();
+    buildLandmarks(DEFAULT_LANDMARKS);
+    _version = nextVersion();
+    resetInstanceVersions();
 }
 
 Arcane::Arcane(uint32_t numNodosParam, uint32_t nodosIniciales) {
@@ -39,6 +61,9 @@ Arcane::Arcane(uint32_t numNodosParam, uint32_t nodosIniciales) {
     assignLevelColors();
     generateArrows();
     assignArrowColors();
+    buildLandmarks(DEFAULT_LANDMARKS);
+    _version = nextVersion();
+    resetInstanceVersions();
 }
 
 // Arcane::Arcane(const Arcane& other)
@@ -46,8 +71,16 @@ Arcane::Arcane(uint32_t numNodosParam, uint32_t nodosIniciales) {
 // }
 
 Arcane::Arcane(Arcane&& other) noexcept
-: _nodos(std::move(other._nodos)), _flechas(std::move(other._flechas)),      
-_niveles(other._niveles), _gen(std::move(other._gen)) {
+: _nodos(std::move(other._nodos)), _flechas(std::move(other._flechas)),
+_primeraFlecha(std::move(other._primeraFlecha)), _extremos(std::move(other._extremos)),
+_calcularTransformaciones(other._calcularTransformaciones),
+_transformacionesPendientes(other._transformacionesPendientes),
+_layoutAplicado(other._layoutAplicado.load(std::memory_order_relaxed)),
+_niveles(other._niveles), _gen(std::move(other._gen)), _landmarks(std::move(other._landmarks)),
+_resaltadas(std::move(other._resaltadas)), _colorResaltado(other._colorResaltado),
+_paleta(std::move(other._paleta)), _estilosNodos(std::move(other._estilosNodos)),
+_estilosFlechas(std::move(other._estilosFlechas)), _version(other._version), _rutas(std::move(other._rutas)) {
+    std::copy(std::begin(other._instancias), std::end(other._instancias), std::begin(_instancias));
     other._niveles = 0;
 }
 
@@ -55,8 +88,22 @@ Arcane& Arcane::operator=(Arcane&& other) noexcept {
     if (this != &other) {
         _nodos = std::move(other._nodos);
         _flechas = std::move(other._flechas);
+        _primeraFlecha = std::move(other._primeraFlecha);
+        _extremos = std::move(other._extremos);
+        _calcularTransformaciones = other._calcularTransformaciones;
+        _transformacionesPendientes = other._transformacionesPendientes;
+        _layoutAplicado.store(other._layoutAplicado.load(std::memory_order_relaxed), std::memory_order_relaxed);
         _niveles = other._niveles;
         _gen = std::move(other._gen);
+        _landmarks = std::move(other._landmarks);
+        _resaltadas = std::move(other._resaltadas);
+        _colorResaltado = other._colorResaltado;
+        _paleta = std::move(other._paleta);
+        _estilosNodos = std::move(other._estilosNodos);
+        _estilosFlechas = std::move(other._estilosFlechas);
+        _version = other._version;
+        _rutas = std::move(other._rutas);
+        std::copy(std::begin(other._instancias), std::end(other._instancias), std::begin(_instancias));
         other._niveles = 0;
     }
     return *this;
@@ -98,7 +145,167 @@ DynamicArray<glm::vec3> Arcane::getArrowColors() const {
     return colors;
 }
 
+DynamicArray<ArrowEndpoints> Arcane::getArrowEndpoints() const {
+    DynamicArray<ArrowEndpoints> endpoints;
+    endpoints.reserve(_flechas.size());
+    for (const auto& arrow : _flechas) {
+        endpoints.push_back({arrow._origen->_posicion, arrow._destino->_posicion});
+    }
+    return endpoints;
+}
+
+// Las escrituras de rangos grandes (p.ej. un buffer mapeado completo cada
+// frame) se reparten entre los hilos del pool; las pequeñas van en serie
+void Arcane::writeNodePositions(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _nodos.data()[first + i]._posicion;
+        }
+    });
+}
+
+void Arcane::writeNodeColors(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _nodos.data()[first + i]._color;
+        }
+    });
+}
+
+void Arcane::writeArrowTransforms(uint32_t first, uint32_t count, glm::mat4* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _flechas.data()[first + i]._transform;
+        }
+    });
+}
+
+void Arcane::writeArrowColors(uint32_t first, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _flechas.data()[first + i]._color;
+        }
+    });
+}
+
+void Arcane::writeArrowEndpoints(uint32_t first, uint32_t count, ArrowEndpoints* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Arrow& arrow = _flechas.data()[first + i];
+            dst[i] = {arrow._origen->_posicion, arrow._destino->_posicion};
+        }
+    });
+}
+
+void Arcane::writeNodeStyles(uint32_t first, uint32_t count, uint32_t* dst) const noexcept {
+    std::copy_n(_estilosNodos.data() + first, count, dst);
+}
+
+void Arcane::writeArrowStyles(uint32_t first, uint32_t count, uint32_t* dst) const noexcept {
+    std::copy_n(_estilosFlechas.data() + first, count, dst);
+}
+
+void Arcane::gatherNodePositions(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _nodos.data()[ids[i]]._posicion;
+        }
+    });
+}
+
+void Arcane::gatherNodeColors(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _nodos.data()[ids[i]]._color;
+        }
+    });
+}
+
+void Arcane::gatherArrowTransforms(const uint32_t* ids, uint32_t count, glm::mat4* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _flechas.data()[ids[i]]._transform;
+        }
+    });
+}
+
+void Arcane::gatherArrowColors(const uint32_t* ids, uint32_t count, glm::vec3* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _flechas.data()[ids[i]]._color;
+        }
+    });
+}
+
+void Arcane::gatherArrowEndpoints(const uint32_t* ids, uint32_t count, ArrowEndpoints* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Arrow& arrow = _flechas.data()[ids[i]];
+            dst[i] = {arrow._origen->_posicion, arrow._destino->_posicion};
+        }
+    });
+}
+
+void Arcane::gatherNodeStyles(const uint32_t* ids, uint32_t count, uint32_t* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _estilosNodos.data()[ids[i]];
+        }
+    });
+}
+
+void Arcane::gatherArrowStyles(const uint32_t* ids, uint32_t count, uint32_t* dst) const noexcept {
+    ThreadPool::instance().parallelFor(count, WRITE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            dst[i] = _estilosFlechas.data()[ids[i]];
+        }
+    });
+}
+
+void Arcane::markDirty(InstanceData data, DirtyRange range) {
+    if (range.empty()) return;
+
+    InstanceVersion& state = _instancias[static_cast<uint32_t>(data)];
+    const bool nodeData = (data == InstanceData::NodePositions || data == InstanceData::NodeColors ||
+                           data == InstanceData::NodeStyles);
+    const uint32_t total = nodeData ? _nodos.size() : _flechas.size();
+
+    // Si el acumulado supera la mitad del buffer se rebasa: quien tenga la
+    // versión anterior sube solo este rango y los más atrasados, todo
+    DirtyRange merged = state.dirty;
+    merged.merge(range);
+    if (merged.size() * 2 > total) {
+        state.base = state.version;
+        state.dirty = range;
+    } else {
+        state.dirty = merged;
+    }
+    state.version = nextVersion();
+}
+
+void Arcane::markDirty(InstanceData data) {
+    const bool nodeData = (data == InstanceData::NodePositions || data == InstanceData::NodeColors ||
+                           data == InstanceData::NodeStyles);
+    markDirty(data, {0, nodeData ? _nodos.size() : _flechas.size()});
+}
+
+void Arcane::resetInstanceVersions() {
+    // Red nueva: nadie tiene estos datos, todo se sube completo
+    for (InstanceVersion& state : _instancias) {
+        state.version = state.base = nextVersion();
+        state.dirty = DirtyRange();
+    }
+}
+
+void Arcane::setArrowTransformsEnabled(bool enabled) {
+    _calcularTransformaciones = enabled;
+    if (enabled && _transformacionesPendientes) {
+        updateAllArrows();
+    }
+}
+
 void Arcane::initializeNodes(uint32_t nodosIniciales) {
+    MULTIVERSO_TRACE_SCOPE("generacion", "initializeNodes");
     if (nodosIniciales < 2) nodosIniciales = 2;
     
     uint32_t limite = nodosIniciales, acumulado = limite;
@@ -180,6 +387,7 @@ bool Arcane::forcedConnection(Node* origen, Node* destino) {
 }
 
 void Arcane::connectNodes() {
+    MULTIVERSO_TRACE_SCOPE("generacion", "connectNodes");
     const uint32_t MAX_ATTEMPTS = 8;
     const uint8_t MAX_CONN = 6;
 
@@ -389,6 +597,7 @@ void Arcane::connectNodes() {
 }
 
 void Arcane::assign3DPositions() {
+    MULTIVERSO_TRACE_SCOPE("generacion", "assign3DPositions");
     // Organizar nodos por nivel
     DynamicArray<DynamicArray<Node*>> nodesByLevel(_niveles + 1);
     for (uint32_t lvl = 0; lvl <= _niveles; ++lvl) {
@@ -427,6 +636,9 @@ void Arcane::assign3DPositions() {
             node->_posicion = glm::vec3(x, y, z) * radius;      
         }
     }
+
+    markDirty(InstanceData::NodePositions);
+    markDirty(InstanceData::ArrowEndpoints);
 }
 
 void Arcane::assignLevelColors() {
@@ -434,9 +646,25 @@ void Arcane::assignLevelColors() {
         node._color = MathUtils::levelToColor(static_cast<float>(node._level), 
                                          static_cast<float>(_niveles));
     }
+    markDirty(InstanceData::NodeColors);
+
+    // Un color por nivel; con más niveles que entradas, niveles contiguos comparten color
+    const uint32_t levels = _niveles + 1;
+    const uint32_t entries = std::min(levels, PALETTE_SIZE);
+    _paleta.clear();
+    for (uint32_t i = 0; i < entries; ++i) {
+        _paleta.push_back(MathUtils::levelToColor(static_cast<float>(i * levels / entries),
+                                                  static_cast<float>(_niveles)));
+    }
+    _estilosNodos.assign(_nodos.size(), 0);
+    for (const Node& node : _nodos) {
+        _estilosNodos[node._id] = node._level * entries / levels;
+    }
+    markDirty(InstanceData::NodeStyles);
 }
 
 void Arcane::generateArrows() {
+    MULTIVERSO_TRACE_SCOPE("generacion", "generateArrows");
     // Calcular número total de flechas para pre-reservar memoria
     uint32_t totalArrows = 0;
     for (const Node& node : _nodos) {
@@ -445,35 +673,176 @@ void Arcane::generateArrows() {
 
     _flechas.clear();
     _flechas.reserve(totalArrows); // Pre-reservar memoria
+    _primeraFlecha.clear();
+    _primeraFlecha.reserve(_nodos.size() + 1);
 
+    // Las flechas quedan agrupadas por origen, en el orden de _output.
+    // La transformación se calcula después, por lotes, en updateAllArrows
     for (Node& originNode : _nodos) {
+        _primeraFlecha.push_back(_flechas.size());
         for (Node* targetNode : originNode._output) {
             if (targetNode != nullptr) {
-                _flechas.push_back(Arrow(&originNode, targetNode));
+                Arrow arrow;
+                arrow._origen = &originNode;
+                arrow._destino = targetNode;
+                _flechas.push_back(arrow);
             }
         }
     }
+    _primeraFlecha.push_back(_flechas.size());
 
     // Actualizar transformaciones de todas las flechas
     updateAllArrows();
 }
 
 void Arcane::updateAllArrows() {
-    for (Arrow& arrow : _flechas) {
-        arrow.updateTransform();
+    // En modo GPU las matrices quedan pendientes hasta que se vuelvan a pedir
+    if (!_calcularTransformaciones) {
+        _transformacionesPendientes = true;
+        return;
     }
+    _transformacionesPendientes = false;
+
+    const uint32_t count = _flechas.size();
+    if (count == 0) return;
+
+    // Cada bloque reúne sus extremos en SoA y escribe las matrices en su sitio
+    reserveArrowEndpoints();
+    ThreadPool::instance().parallelFor(count, 4096, [&](uint32_t, uint32_t begin, uint32_t end) {
+        computeArrowTransforms(begin, end);
+    });
+
+    markDirty(InstanceData::ArrowTransforms);
+}
+
+void Arcane::reserveArrowEndpoints() {
+    const uint32_t count = _flechas.size();
+    ArrowEndpointsSoA& soa = _extremos;
+    if (soa.ox.size() != count) {
+        soa.ox.assign(count, 0.0f); soa.oy.assign(count, 0.0f); soa.oz.assign(count, 0.0f);
+        soa.dx.assign(count, 0.0f); soa.dy.assign(count, 0.0f); soa.dz.assign(count, 0.0f);
+    }
+}
+
+void Arcane::computeArrowTransforms(uint32_t begin, uint32_t end) noexcept {
+    ArrowEndpointsSoA& soa = _extremos;
+    for (uint32_t i = begin; i < end; ++i) {
+        const Arrow& arrow = _flechas.data()[i];
+        const glm::vec3& o = arrow._origen->_posicion;
+        const glm::vec3& d = arrow._destino->_posicion;
+        soa.ox.data()[i] = o.x; soa.oy.data()[i] = o.y; soa.oz.data()[i] = o.z;
+        soa.dx.data()[i] = d.x; soa.dy.data()[i] = d.y; soa.dz.data()[i] = d.z;
+    }
+
+    ArrowKernel::Endpoints endpoints{
+        soa.ox.data() + begin, soa.oy.data() + begin, soa.oz.data() + begin,
+        soa.dx.data() + begin, soa.dy.data() + begin, soa.dz.data() + begin
+    };
+    ArrowKernel::computeTransforms(endpoints, end - begin, &_flechas.data()[begin]._transform, sizeof(Arrow));
+}
+
+uint32_t Arcane::moveNodes(const glm::vec3* positions) {
+    MULTIVERSO_TRACE_SCOPE("layout", "moveNodes");
+    const uint32_t numNodes = _nodos.size();
+    const uint32_t numArrows = _flechas.size();
+    if (numNodes == 0) return 0;
+    _layoutAplicado.store(true, std::memory_order_release);
+
+    ThreadPool& pool = ThreadPool::instance();
+    _movidos.assign(numNodes, 0);
+
+    // Rangos y recuentos por hilo, combinados al final
+    struct Moved {
+        DirtyRange nodes;
+        DirtyRange arrows;
+        uint32_t count = 0;
+    };
+    DynamicArray<Moved> perWorker;
+    perWorker.assign(pool.size(), Moved());
+
+    // ----- NODOS -----
+    pool.parallelFor(numNodes, WRITE_GRAIN, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        Moved& moved = perWorker.data()[worker];
+        for (uint32_t i = begin; i < end; ++i) {
+            Node& node = _nodos.data()[i];
+            if (node._posicion == positions[i]) continue;
+            node._posicion = positions[i];
+            _movidos.data()[i] = 1;
+            moved.nodes.add(i);
+            ++moved.count;
+        }
+    });
+
+    DirtyRange nodes;
+    uint32_t count = 0;
+    for (const Moved& moved : perWorker) {
+        nodes.merge(moved.nodes);
+        count += moved.count;
+    }
+    if (count == 0) return 0;
+
+    // ----- FLECHAS -----
+    // Solo las que tocan un nodo movido; las contiguas se calculan en un
+    // lote del kernel. En modo GPU bastan los extremos
+    const bool transforms = _calcularTransformaciones;
+    if (transforms) reserveArrowEndpoints();
+    else _transformacionesPendientes = true;
+
+    const uint8_t* movidos = _movidos.data();
+    pool.parallelFor(numArrows, WRITE_GRAIN, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        Moved& moved = perWorker.data()[worker];
+        auto touched = [&](uint32_t i) {
+            const Arrow& arrow = _flechas.data()[i];
+            return movidos[arrow._origen->_id] || movidos[arrow._destino->_id];
+        };
+
+        uint32_t i = begin;
+        while (i < end) {
+            if (!touched(i)) { ++i; continue; }
+            uint32_t run = i + 1;
+            while (run < end && touched(run)) ++run;
+
+            if (transforms) computeArrowTransforms(i, run);
+            moved.arrows.merge({i, run});
+            i = run;
+        }
+    });
+
+    DirtyRange arrows;
+    for (const Moved& moved : perWorker) arrows.merge(moved.arrows);
+
+    markDirty(InstanceData::NodePositions, nodes);
+    markDirty(InstanceData::ArrowEndpoints, arrows);
+    if (transforms) markDirty(InstanceData::ArrowTransforms, arrows);
+    return count;
 }
 
 void Arcane::assignArrowColors() {
-    const float oscuridad = 0.7f;
-    for (auto& arrow : _flechas) {
+    _estilosFlechas.assign(_flechas.size(), 0);
+    for (uint32_t i = 0; i < _flechas.size(); ++i) {
+        Arrow& arrow = _flechas[i];
         if (arrow._origen) {
-            arrow._color = arrow._origen->_color * oscuridad;
+            arrow._color = baseArrowColor(arrow);
+            _estilosFlechas[i] = _estilosNodos[arrow._origen->_id];
         }
     }
+
+    // Mantener el resaltado vigente
+    for (uint32_t index : _resaltadas) {
+        _flechas[index]._color = _colorResaltado;
+        _estilosFlechas[index] |= InstanceStyle::HIGHLIGHTED;
+    }
+
+    markDirty(InstanceData::ArrowColors);
+    markDirty(InstanceData::ArrowStyles);
 }
 
-DynamicArray<const Node*> Arcane::findPath(uint32_t idOrigen, uint32_t idDestino) const {
+glm::vec3 Arcane::baseArrowColor(const Arrow& arrow) const noexcept {
+    return arrow._origen ? arrow._origen->_color * ARROW_SHADE : arrow._color;
+}
+
+DynamicArray<const Node*> Arcane::findPath(uint32_t idOrigen, uint32_t idDestino, PathMode mode) const {
+    MULTIVERSO_TRACE_SCOPE("ruta", mode == PathMode::ALT ? "findPath (ALT)" : "findPath (BFS)");
     // Validar IDs
     if (idOrigen >= _nodos.size() || idDestino >= _nodos.size()) {
         return DynamicArray<const Node*>();
@@ -486,28 +855,60 @@ DynamicArray<const Node*> Arcane::findPath(uint32_t idOrigen, uint32_t idDestino
         return path;
     }
 
-    // Vector de padres (en lugar de std::vector<int>)
-    DynamicArray<int> parent(_nodos.size());
-    for (uint32_t i = 0; i < _nodos.size(); ++i) {
-        parent.push_back(-1);
+    // Sin landmarks, ALT es un BFS y comparte sus entradas de caché
+    if (_landmarks.empty()) mode = PathMode::BFS;
+    const uint8_t modeKey = static_cast<uint8_t>(mode);
+
+    // ----- CACHÉ DE RUTAS -----
+    if (const DynamicArray<uint32_t>* cached = _rutas.find(_version, idOrigen, idDestino, modeKey)) {
+        return toNodePath(*cached);
+    }
+
+    DynamicArray<uint32_t> ids;
+    if (mode == PathMode::ALT) {
+        _rutas.recordMiss();
+        ids = findPathALT(idOrigen, idDestino);
+    } else {
+        // Un BFS completo desde el origen responde a cualquier destino posterior
+        const DynamicArray<int32_t>* tree = _rutas.findTree(_version, idOrigen);
+        if (tree) {
+            _rutas.recordTreeHit();
+        } else {
+            _rutas.recordMiss();
+            DynamicArray<int32_t>& slot = _rutas.insertTree(_version, idOrigen);
+            buildShortestPathTree(idOrigen, slot);
+            tree = &slot;
+        }
+        
+        // Sin padre y distinto del origen: inalcanzable
+        if ((*tree)[idDestino] != -1) {
+            ids = buildPath(*tree, idDestino);
+        }
     }
+
+    DynamicArray<const Node*> path = toNodePath(ids);
+    _rutas.insert(_version, idOrigen, idDestino, modeKey, std::move(ids));
+    return path;
+}
+
+void Arcane::buildShortestPathTree(uint32_t idOrigen, DynamicArray<int32_t>& parent) const {
+    // Vector de padres (-1 = no visitado)
+    parent.assign(_nodos.size(), -1);
     
     // Vector de visitados (en lugar de std::vector<char>)
-    DynamicArray<bool> visited(_nodos.size());
-    for (uint32_t i = 0; i < _nodos.size(); ++i) {
-        visited.push_back(false);
-    }
+    DynamicArray<bool> visited;
+    visited.assign(_nodos.size(), false);
     
     // Queue manual usando DynamicArray (FIFO)
     DynamicArray<uint32_t> queue;
+    queue.reserve(_nodos.size());
     queue.push_back(idOrigen);
     visited[idOrigen] = true;
     
-    bool found = false;
     uint32_t queueIndex = 0;  // Índice para simular pop_front
     
-    // BFS manual
-    while (queueIndex < queue.size() && !found) {
+    // BFS manual completo (sin corte en el destino)
+    while (queueIndex < queue.size()) {
         uint32_t currentId = queue[queueIndex++];
         const Node& currentNode = _nodos[currentId];
         
@@ -519,36 +920,84 @@ DynamicArray<const Node*> Arcane::findPath(uint32_t idOrigen, uint32_t idDestino
             uint32_t neighborId = neighbor->_id;
             if (!visited[neighborId]) {
                 visited[neighborId] = true;
-                parent[neighborId] = static_cast<int>(currentId);
-                
-                if (neighborId == idDestino) {
-                    found = true;
-                    break;
-                }
-                
+                parent[neighborId] = static_cast<int32_t>(currentId);
                 queue.push_back(neighborId);
             }
         }
     }
-    
-    // Si no se encontró camino
+}
+
+DynamicArray<uint32_t> Arcane::findPathALT(uint32_t idOrigen, uint32_t idDestino) const {
+    // Cota inferior inalcanzable: no hace falta buscar
+    if (_landmarks.bounds(idOrigen, idDestino).unreachable()) {
+        return DynamicArray<uint32_t>();
+    }
+
+    const uint32_t n = _nodos.size();
+    const uint32_t NO_VISITADO = 0xFFFFFFFFu;
+
+    DynamicArray<int32_t> parent;
+    parent.assign(n, -1);
+    DynamicArray<uint32_t> g;
+    g.assign(n, NO_VISITADO);
+
+    // Montículo binario (f, id) con min en la cima
+    struct Entry { uint32_t f; uint32_t id; };
+    auto cmp = [](const Entry& a, const Entry& b) { return a.f > b.f; };
+    DynamicArray<Entry> open;
+
+    g[idOrigen] = 0;
+    open.push_back({_landmarks.lowerBound(idOrigen, idDestino), idOrigen});
+
+    // ----- A* con heurística ALT (consistente: cada nodo se cierra una vez) -----
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), cmp);
+        Entry current = open.pop_back();
+        
+        uint32_t currentG = g[current.id];
+        if (current.f != currentG + _landmarks.lowerBound(current.id, idDestino)) continue;  // Entrada obsoleta
+        
+        if (current.id == idDestino) {
+            found = true;
+            break;
+        }
+        
+        const Node& currentNode = _nodos[current.id];
+        for (const Node* neighbor : currentNode._output) {
+            if (!neighbor) continue;
+            
+            uint32_t neighborId = neighbor->_id;
+            if (currentG + 1 < g[neighborId]) {
+                g[neighborId] = currentG + 1;
+                parent[neighborId] = static_cast<int32_t>(current.id);
+                open.push_back({currentG + 1 + _landmarks.lowerBound(neighborId, idDestino), neighborId});
+                std::push_heap(open.begin(), open.end(), cmp);
+            }
+        }
+    }
+
     if (!found) {
-        return DynamicArray<const Node*>();
+        return DynamicArray<uint32_t>();
     }
-    
+
+    return buildPath(parent, idDestino);
+}
+
+DynamicArray<uint32_t> Arcane::buildPath(const DynamicArray<int32_t>& parent, uint32_t idDestino) const {
     // ----- RECONSTRUIR CAMINO -----
-    DynamicArray<const Node*> path;
-    int current = static_cast<int>(idDestino);
+    DynamicArray<uint32_t> path;
+    int32_t current = static_cast<int32_t>(idDestino);
     
     // Reconstruir de destino a origen
     while (current != -1) {
-        path.push_back(&_nodos[current]);
+        path.push_back(static_cast<uint32_t>(current));
         current = parent[current];
     }
     
     // Invertir el camino (origen -> destino)
     for (uint32_t i = 0; i < path.size() / 2; ++i) {
-        const Node* temp = path[i];
+        uint32_t temp = path[i];
         path[i] = path[path.size() - 1 - i];
         path[path.size() - 1 - i] = temp;
     }
@@ -556,46 +1005,163 @@ DynamicArray<const Node*> Arcane::findPath(uint32_t idOrigen, uint32_t idDestino
     return path;
 }
 
-DynamicArray<glm::vec3> Arcane::highlightPath(const DynamicArray<const Node*>& path, 
-                                             glm::vec3 highlightColor) {
-    DynamicArray<glm::vec3> colors;
-    colors.reserve(_flechas.size());
+DynamicArray<const Node*> Arcane::toNodePath(const DynamicArray<uint32_t>& ids) const {
+    DynamicArray<const Node*> path(ids.size());
+    for (uint32_t id : ids) {
+        path.push_back(&_nodos[id]);
+    }
+    return path;
+}
+
+int32_t Arcane::findArrow(uint32_t idOrigen, uint32_t idDestino) const noexcept {
+    if (idOrigen >= _nodos.size() || _primeraFlecha.size() != _nodos.size() + 1) return -1;
 
-    // Guardar colores originales temporalmente
-    DynamicArray<glm::vec3> originalColors;
-    originalColors.reserve(_flechas.size());
-    for (const Arrow& arrow : _flechas) {
-        originalColors.push_back(arrow._color);
+    // Las flechas de un origen son contiguas y siguen el orden de su _output
+    const uint32_t first = _primeraFlecha.data()[idOrigen];
+    const uint32_t last = _primeraFlecha.data()[idOrigen + 1];
+    for (uint32_t index = first; index < last; ++index) {
+        if (_flechas.data()[index]._destino->_id == idDestino) {
+            return static_cast<int32_t>(index);
+        }
     }
+    return -1;
+}
 
-    // Reiniciar a colores base
-    assignArrowColors();
+DirtyRange Arcane::highlightPath(const DynamicArray<const Node*>& path, glm::vec3 highlightColor) {
+    // Restaurar solo las flechas del resaltado anterior
+    DirtyRange dirty = restoreHighlighted();
+    _colorResaltado = highlightColor;
 
     // Aplicar highlight si el path es válido
-    if (path.size() >= 2) {
-        for (uint32_t i = 0; i + 1 < path.size(); ++i) {
-            const Node* from = path[i];
-            const Node* to = path[i + 1];
-            
-            if (!from || !to) continue;
-            
-            for (Arrow& arrow : _flechas) {
-                if (arrow._origen && arrow._destino &&
-                    arrow._origen->_id == from->_id && 
-                    arrow._destino->_id == to->_id) {
-                    
-                    arrow._color = highlightColor;
-                    break;
+    for (uint32_t i = 0; i + 1 < path.size(); ++i) {
+        const Node* from = path[i];
+        const Node* to = path[i + 1];
+        
+        if (!from || !to) continue;
+
+        int32_t index = findArrow(from->_id, to->_id);
+        if (index < 0) continue;
+
+        _flechas[index]._color = highlightColor;
+        _estilosFlechas[index] |= InstanceStyle::HIGHLIGHTED;
+        _resaltadas.push_back(static_cast<uint32_t>(index));
+        dirty.add(static_cast<uint32_t>(index));
+    }
+
+    markDirty(InstanceData::ArrowColors, dirty);
+    markDirty(InstanceData::ArrowStyles, dirty);
+    return dirty;
+}
+
+DirtyRange Arcane::clearHighlight() {
+    DirtyRange dirty = restoreHighlighted();
+    markDirty(InstanceData::ArrowColors, dirty);
+    markDirty(InstanceData::ArrowStyles, dirty);
+    return dirty;
+}
+
+DirtyRange Arcane::restoreHighlighted() {
+    DirtyRange dirty;
+    for (uint32_t index : _resaltadas) {
+        _flechas[index]._color = baseArrowColor(_flechas[index]);
+        _estilosFlechas[index] &= ~InstanceStyle::HIGHLIGHTED;
+        dirty.add(index);
+    }
+    _resaltadas.clear();
+    return dirty;
+}
+    
+Neighborhood Arcane::neighborhood(uint32_t id, uint32_t hops, NeighborDirection direction) const {
+    Neighborhood result;
+    if (id >= _nodos.size()) return result;
+
+    // Reutilizar las fronteras mientras el tamaño de la red no cambie
+    NeighborhoodWorkspace& ws = _vecindad;
+    if (ws.visited.size() != _nodos.size()) {
+        ws.visited.resize(_nodos.size());
+        ws.frontier.resize(_nodos.size());
+        ws.next.resize(_nodos.size());
+    } else {
+        ws.visited.clear();
+        ws.frontier.clear();
+    }
+
+    const bool followOutput = direction != NeighborDirection::Input;
+    const bool followInput = direction != NeighborDirection::Output;
+
+    ws.visited.set(id);
+    ws.frontier.set(id);
+
+    // ----- EXPANSIÓN POR NIVELES CON FRONTERAS DE BITS -----
+    for (uint32_t hop = 0; hop < hops && ws.frontier.any(); ++hop) {
+        ws.next.clear();
+        ws.frontier.forEach([&](uint32_t current) {
+            const Node& node = _nodos.data()[current];
+            if (followOutput) {
+                for (const Node* neighbor : node._output) {
+                    if (neighbor && ws.visited.testAndSet(neighbor->_id)) ws.next.set(neighbor->_id);
+                }
+            }
+            if (followInput) {
+                for (const Node* neighbor : node._input) {
+                    if (neighbor && ws.visited.testAndSet(neighbor->_id)) ws.next.set(neighbor->_id);
                 }
             }
+        });
+        ws.frontier.swap(ws.next);
+    }
+
+    // ----- RECOGER NODOS Y FLECHAS INTERNAS -----
+    result.nodes.reserve(ws.visited.count());
+    ws.visited.forEach([&](uint32_t current) {
+        result.nodes.push_back(current);
+
+        const Node& node = _nodos.data()[current];
+        uint32_t arrow = _primeraFlecha[current];
+        for (const Node* target : node._output) {
+            if (!target) continue;
+            if (ws.visited.test(target->_id)) result.arrows.push_back(arrow);
+            ++arrow;
         }
+    });
+
+    return result;
+}
+
+void Arcane::buildLandmarks(uint32_t count, LandmarkOracle::Strategy strategy) {
+    MULTIVERSO_TRACE_SCOPE("generacion", "buildLandmarks");
+    _landmarks.build(_nodos, count, strategy);
+}
+
+void Arcane::applyNodeMetric(const DynamicArray<float>& values) {
+    if (values.size() != _nodos.size() || values.empty()) return;
+
+    // Normalizar min-max para mapear al gradiente
+    float minValue = values[0], maxValue = values[0];
+    for (float v : values) {
+        minValue = std::min(minValue, v);
+        maxValue = std::max(maxValue, v);
     }
+    const float range = maxValue - minValue;
 
-    // Recoger colores resultantes
-    for (const Arrow& arrow : _flechas) {
-        colors.push_back(arrow._color);
+    for (Node& node : _nodos) {
+        float t = range > 0.0f ? (values[node._id] - minValue) / range : 0.0f;
+        node._color = MathUtils::metricToColor(t);
+        _estilosNodos[node._id] = static_cast<uint32_t>(t * static_cast<float>(PALETTE_SIZE - 1) + 0.5f);
     }
+    markDirty(InstanceData::NodeColors);
 
-    return colors;
+    // Paleta: el gradiente en PALETTE_SIZE tramos
+    _paleta.clear();
+    for (uint32_t i = 0; i < PALETTE_SIZE; ++i) {
+        _paleta.push_back(MathUtils::metricToColor(static_cast<float>(i) / static_cast<float>(PALETTE_SIZE - 1)));
+    }
+    markDirty(InstanceData::NodeStyles);
+
+    assignArrowColors();
+}
+
+void Arcane::resetNodeColors() {
+    assignLevelColors();
+    assignArrowColors();
 }
-    
\ No newline at end of file
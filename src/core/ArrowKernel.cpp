@@ -0,0 +1,209 @@
+#include "core/ArrowKernel.hpp"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define ARROW_KERNEL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ARROW_KERNEL_SSE2 1
+#endif
+
+namespace {
+    constexpr float EPS_DIST = 1e-5f;       // Mismo umbral que Arrow::updateTransform
+    constexpr float EPS_AXIS2 = 1e-12f;     // |eje| > 1e-6, comparado al cuadrado
+
+    // ----- Carriles: misma interfaz para escalar, SSE y AVX2 -----
+
+    struct Lane1 {
+        static constexpr uint32_t W = 1;
+        using Mask = bool;
+        float v;
+
+        static Lane1 load(const float* p) noexcept { return {*p}; }
+        static Lane1 set(float x) noexcept { return {x}; }
+        void store(float* p) const noexcept { *p = v; }
+
+        friend Lane1 operator+(Lane1 a, Lane1 b) noexcept { return {a.v + b.v}; }
+        friend Lane1 operator-(Lane1 a, Lane1 b) noexcept { return {a.v - b.v}; }
+        friend Lane1 operator*(Lane1 a, Lane1 b) noexcept { return {a.v * b.v}; }
+        friend Lane1 operator/(Lane1 a, Lane1 b) noexcept { return {a.v / b.v}; }
+        friend Lane1 sqrt(Lane1 a) noexcept { return {std::sqrt(a.v)}; }
+        friend Lane1 abs(Lane1 a) noexcept { return {std::fabs(a.v)}; }
+        friend Mask operator>=(Lane1 a, Lane1 b) noexcept { return a.v >= b.v; }
+        friend Mask operator>(Lane1 a, Lane1 b) noexcept { return a.v > b.v; }
+        friend Mask operator<(Lane1 a, Lane1 b) noexcept { return a.v < b.v; }
+        friend Lane1 select(Mask m, Lane1 a, Lane1 b) noexcept { return m ? a : b; }
+    };
+    inline bool maskAnd(bool a, bool b) noexcept { return a && b; }
+
+#if defined(ARROW_KERNEL_SSE2)
+    struct Lane4 {
+        static constexpr uint32_t W = 4;
+        using Mask = __m128;
+        __m128 v;
+
+        static Lane4 load(const float* p) noexcept { return {_mm_loadu_ps(p)}; }
+        static Lane4 set(float x) noexcept { return {_mm_set1_ps(x)}; }
+        void store(float* p) const noexcept { _mm_storeu_ps(p, v); }
+
+        friend Lane4 operator+(Lane4 a, Lane4 b) noexcept { return {_mm_add_ps(a.v, b.v)}; }
+        friend Lane4 operator-(Lane4 a, Lane4 b) noexcept { return {_mm_sub_ps(a.v, b.v)}; }
+        friend Lane4 operator*(Lane4 a, Lane4 b) noexcept { return {_mm_mul_ps(a.v, b.v)}; }
+        friend Lane4 operator/(Lane4 a, Lane4 b) noexcept { return {_mm_div_ps(a.v, b.v)}; }
+        friend Lane4 sqrt(Lane4 a) noexcept { return {_mm_sqrt_ps(a.v)}; }
+        friend Lane4 abs(Lane4 a) noexcept { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+        friend Mask operator>=(Lane4 a, Lane4 b) noexcept { return _mm_cmpge_ps(a.v, b.v); }
+        friend Mask operator>(Lane4 a, Lane4 b) noexcept { return _mm_cmpgt_ps(a.v, b.v); }
+        friend Mask operator<(Lane4 a, Lane4 b) noexcept { return _mm_cmplt_ps(a.v, b.v); }
+        friend Lane4 select(Mask m, Lane4 a, Lane4 b) noexcept {
+            return {_mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v))};
+        }
+    };
+    inline __m128 maskAnd(__m128 a, __m128 b) noexcept { return _mm_and_ps(a, b); }
+    using LaneSimd = Lane4;
+#endif
+
+#if defined(ARROW_KERNEL_AVX2)
+    struct Lane8 {
+        static constexpr uint32_t W = 8;
+        using Mask = __m256;
+        __m256 v;
+
+        static Lane8 load(const float* p) noexcept { return {_mm256_loadu_ps(p)}; }
+        static Lane8 set(float x) noexcept { return {_mm256_set1_ps(x)}; }
+        void store(float* p) const noexcept { _mm256_storeu_ps(p, v); }
+
+        friend Lane8 operator+(Lane8 a, Lane8 b) noexcept { return {_mm256_add_ps(a.v, b.v)}; }
+        friend Lane8 operator-(Lane8 a, Lane8 b) noexcept { return {_mm256_sub_ps(a.v, b.v)}; }
+        friend Lane8 operator*(Lane8 a, Lane8 b) noexcept { return {_mm256_mul_ps(a.v, b.v)}; }
+        friend Lane8 operator/(Lane8 a, Lane8 b) noexcept { return {_mm256_div_ps(a.v, b.v)}; }
+        friend Lane8 sqrt(Lane8 a) noexcept { return {_mm256_sqrt_ps(a.v)}; }
+        friend Lane8 abs(Lane8 a) noexcept { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+        friend Mask operator>=(Lane8 a, Lane8 b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+        friend Mask operator>(Lane8 a, Lane8 b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+        friend Mask operator<(Lane8 a, Lane8 b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+        friend Lane8 select(Mask m, Lane8 a, Lane8 b) noexcept { return {_mm256_blendv_ps(b.v, a.v, m)}; }
+    };
+    inline __m256 maskAnd(__m256 a, __m256 b) noexcept { return _mm256_and_ps(a, b); }
+    using LaneSimd = Lane8;
+#endif
+
+    // ----- Núcleo: W flechas a la vez, resultado en columnas SoA -----
+    // res[k][carril], k = columna * 4 + fila (orden de glm::mat4)
+    template<typename V>
+    inline void transformBlock(const ArrowKernel::Endpoints& e, uint32_t i,
+                               float sphereRadius, float thickness, float (&res)[16][V::W]) noexcept {
+        const V zero = V::set(0.0f), one = V::set(1.0f);
+        const V radius = V::set(sphereRadius), t = V::set(thickness);
+
+        const V sx = V::load(e.ox + i), sy = V::load(e.oy + i), sz = V::load(e.oz + i);
+        const V dx = V::load(e.dx + i) - sx, dy = V::load(e.dy + i) - sy, dz = V::load(e.dz + i) - sz;
+
+        // Dirección y recorte por el radio de las esferas
+        const V dist = sqrt(dx * dx + dy * dy + dz * dz);
+        auto valid = dist >= V::set(EPS_DIST);
+        const V inv = one / select(valid, dist, one);
+        const V nx = dx * inv, ny = dy * inv, nz = dz * inv;
+
+        const V stx = sx + nx * radius, sty = sy + ny * radius, stz = sz + nz * radius;
+        const V adjusted = dist - radius - radius;
+        const V len = abs(adjusted);
+        valid = maskAnd(valid, len >= V::set(EPS_DIST));
+
+        // Si las esferas se solapan la dirección se invierte, como en updateTransform
+        const V sign = select(adjusted < zero, V::set(-1.0f), one);
+        const V ux = nx * sign, uy = ny * sign, uz = nz * sign;
+
+        // Rotación de arco mínimo Y -> u: eje v = Y x u = (uz, 0, -ux), c = u.y
+        // R = c*I + [v]x + v*v^T / (1 + c); para c < 0 se usa (1 - c) / |v|^2
+        const V s2 = uz * uz + ux * ux;
+        const auto rot = s2 > V::set(EPS_AXIS2);
+        const V c = select(rot, uy, one);
+        const V vx = select(rot, uz, zero);
+        const V vz = select(rot, zero - ux, zero);
+        const V hPos = one / (one + c);
+        const V hNeg = (one - c) / select(rot, s2, one);
+        const V h = select(rot, select(c >= zero, hPos, hNeg), zero);
+
+        const V hxz = h * vx * vz;
+
+        // M = T * R * S(t, len, t) * Rx(-90°): columnas en forma cerrada
+        V m[16] = {
+            t * (c + h * vx * vx), t * vz, t * hxz, zero,
+            zero - t * hxz, t * vx, zero - t * (c + h * vz * vz), zero,
+            len * (zero - vz), len * c, len * vx, zero,
+            stx, sty, stz, one
+        };
+
+        // Identidad para flechas degeneradas
+        const V identity[16] = {
+            one, zero, zero, zero,  zero, one, zero, zero,
+            zero, zero, one, zero,  zero, zero, zero, one
+        };
+        for (uint32_t k = 0; k < 16; ++k) {
+            select(valid, m[k], identity[k]).store(res[k]);
+        }
+    }
+
+    // Transpone el lote SoA a matrices AoS con separación arbitraria
+    template<uint32_t W>
+    inline void scatter(const float (&res)[16][W], uint32_t lanes, unsigned char* out, size_t stride) noexcept {
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            float* matrix = reinterpret_cast<float*>(out + lane * stride);
+            for (uint32_t k = 0; k < 16; ++k) {
+                matrix[k] = res[k][lane];
+            }
+        }
+    }
+
+    template<typename V>
+    void run(const ArrowKernel::Endpoints& e, uint32_t begin, uint32_t end,
+             unsigned char* out, size_t stride, float sphereRadius, float thickness) noexcept {
+        alignas(32) float res[16][V::W];
+        for (uint32_t i = begin; i + V::W <= end; i += V::W) {
+            transformBlock<V>(e, i, sphereRadius, thickness, res);
+            scatter<V::W>(res, V::W, out + i * stride, stride);
+        }
+    }
+}
+
+void ArrowKernel::computeTransforms(const Endpoints& endpoints, uint32_t count,
+                                    glm::mat4* out, size_t outStride,
+                                    float sphereRadius, float thickness) noexcept {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(out);
+    uint32_t simdEnd = 0;
+
+#if defined(ARROW_KERNEL_AVX2) || defined(ARROW_KERNEL_SSE2)
+    simdEnd = count - count % LaneSimd::W;
+    run<LaneSimd>(endpoints, 0, simdEnd, bytes, outStride, sphereRadius, thickness);
+#endif
+
+    // Cola escalar
+    run<Lane1>(endpoints, simdEnd, count, bytes, outStride, sphereRadius, thickness);
+}
+
+void ArrowKernel::computeTransformsScalar(const Endpoints& endpoints, uint32_t count,
+                                          glm::mat4* out, size_t outStride,
+                                          float sphereRadius, float thickness) noexcept {
+    run<Lane1>(endpoints, 0, count, reinterpret_cast<unsigned char*>(out), outStride, sphereRadius, thickness);
+}
+
+const char* ArrowKernel::instructionSet() noexcept {
+#if defined(ARROW_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(ARROW_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "Escalar";
+#endif
+}
+
+uint32_t ArrowKernel::laneWidth() noexcept {
+#if defined(ARROW_KERNEL_AVX2) || defined(ARROW_KERNEL_SSE2)
+    return LaneSimd::W;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,205 @@
+#include "core/Centrality.hpp"
+#include "core/Arcane.hpp"
+#include "core/CompactGraph.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    // Estado de BFS reutilizado por cada hilo entre orígenes
+    struct Workspace {
+        DynamicArray<int32_t> dist;
+        DynamicArray<double> sigma;
+        DynamicArray<double> delta;
+        DynamicArray<uint32_t> order;
+        DynamicArray<double> acc;       // Acumulador por hilo
+
+        explicit Workspace(uint32_t n) {
+            dist.assign(n, -1);
+            sigma.assign(n, 0.0);
+            delta.assign(n, 0.0);
+            order.reserve(n);
+            acc.assign(n, 0.0);
+        }
+    };
+
+    // Orígenes a recorrer: todos, o k pivotes distintos al azar
+    DynamicArray<uint32_t> pickSources(uint32_t n, uint32_t samples, uint32_t seed) {
+        DynamicArray<uint32_t> sources;
+        sources.reserve(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            sources.push_back(i);
+        }
+
+        if (samples == 0 || samples >= n) return sources;
+
+        // Fisher-Yates parcial: solo los primeros k
+        std::mt19937 gen(seed);
+        for (uint32_t i = 0; i < samples; ++i) {
+            std::uniform_int_distribution<uint32_t> pick(i, n - 1);
+            std::swap(sources[i], sources[pick(gen)]);
+        }
+
+        DynamicArray<uint32_t> pivots(samples);
+        for (uint32_t i = 0; i < samples; ++i) {
+            pivots.push_back(sources[i]);
+        }
+        return pivots;
+    }
+
+    // Suma los acumuladores de todos los hilos en el resultado final
+    DynamicArray<float> reduce(std::vector<Workspace>& workspaces, uint32_t n, double scale) {
+        DynamicArray<float> result;
+        result.assign(n, 0.0f);
+
+        ThreadPool::instance().parallelFor(n, 4096, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t v = begin; v < end; ++v) {
+                double sum = 0.0;
+                for (const Workspace& ws : workspaces) {
+                    sum += ws.acc.data()[v];
+                }
+                result.data()[v] = static_cast<float>(sum * scale);
+            }
+        });
+        return result;
+    }
+}
+
+DynamicArray<float> Centrality::betweenness(const Arcane& arcane, uint32_t samples, uint32_t seed) {
+    const CompactGraph graph(arcane.getNodes());
+    const uint32_t n = graph.numNodes();
+    if (n == 0) return DynamicArray<float>();
+
+    const DynamicArray<uint32_t> sources = pickSources(n, samples, seed);
+
+    ThreadPool& pool = ThreadPool::instance();
+    std::vector<Workspace> workspaces;
+    workspaces.reserve(pool.size());
+    for (uint32_t t = 0; t < pool.size(); ++t) {
+        workspaces.emplace_back(n);
+    }
+
+    pool.parallelFor(sources.size(), 1, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        Workspace& ws = workspaces[worker];
+        int32_t* dist = ws.dist.data();
+        double* sigma = ws.sigma.data();
+        double* delta = ws.delta.data();
+        double* acc = ws.acc.data();
+
+        for (uint32_t si = begin; si < end; ++si) {
+            const uint32_t s = sources.data()[si];
+
+            // ----- BFS: distancias y número de caminos mínimos -----
+            ws.order.clear();
+            ws.order.push_back(s);
+            dist[s] = 0;
+            sigma[s] = 1.0;
+
+            for (uint32_t head = 0; head < ws.order.size(); ++head) {
+                const uint32_t v = ws.order.data()[head];
+                for (const uint32_t* w = graph.outBegin(v); w != graph.outEnd(v); ++w) {
+                    if (dist[*w] < 0) {
+                        dist[*w] = dist[v] + 1;
+                        ws.order.push_back(*w);
+                    }
+                    if (dist[*w] == dist[v] + 1) {
+                        sigma[*w] += sigma[v];
+                    }
+                }
+            }
+
+            // ----- Acumulación de dependencias en orden inverso -----
+            for (uint32_t i = ws.order.size(); i-- > 1;) {
+                const uint32_t w = ws.order.data()[i];
+                const double coeff = (1.0 + delta[w]) / sigma[w];
+                for (const uint32_t* v = graph.inBegin(w); v != graph.inEnd(w); ++v) {
+                    if (dist[*v] == dist[w] - 1) {
+                        delta[*v] += sigma[*v] * coeff;
+                    }
+                }
+                acc[w] += delta[w];
+            }
+
+            // Reiniciar solo lo visitado
+            for (uint32_t v : ws.order) {
+                dist[v] = -1;
+                sigma[v] = 0.0;
+                delta[v] = 0.0;
+            }
+        }
+    });
+
+    const double scale = static_cast<double>(n) / static_cast<double>(sources.size());
+    return reduce(workspaces, n, scale);
+}
+
+DynamicArray<float> Centrality::closeness(const Arcane& arcane, uint32_t samples, uint32_t seed) {
+    const CompactGraph graph(arcane.getNodes());
+    const uint32_t n = graph.numNodes();
+    if (n < 2) return DynamicArray<float>();
+
+    const DynamicArray<uint32_t> sources = pickSources(n, samples, seed);
+
+    ThreadPool& pool = ThreadPool::instance();
+    std::vector<Workspace> workspaces;
+    workspaces.reserve(pool.size());
+    for (uint32_t t = 0; t < pool.size(); ++t) {
+        workspaces.emplace_back(n);
+    }
+
+    // BFS inverso (sobre _input) desde cada pivote u: para todo x alcanzado,
+    // d(x, u) contribuye 1/d al valor armónico de x
+    pool.parallelFor(sources.size(), 1, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        Workspace& ws = workspaces[worker];
+        int32_t* dist = ws.dist.data();
+        double* acc = ws.acc.data();
+
+        for (uint32_t si = begin; si < end; ++si) {
+            const uint32_t u = sources.data()[si];
+
+            ws.order.clear();
+            ws.order.push_back(u);
+            dist[u] = 0;
+
+            for (uint32_t head = 0; head < ws.order.size(); ++head) {
+                const uint32_t v = ws.order.data()[head];
+                for (const uint32_t* x = graph.inBegin(v); x != graph.inEnd(v); ++x) {
+                    if (dist[*x] < 0) {
+                        dist[*x] = dist[v] + 1;
+                        acc[*x] += 1.0 / dist[*x];
+                        ws.order.push_back(*x);
+                    }
+                }
+            }
+
+            for (uint32_t v : ws.order) {
+                dist[v] = -1;
+            }
+        }
+    });
+
+    const double scale = static_cast<double>(n) / static_cast<double>(sources.size())
+                       / static_cast<double>(n - 1);
+    return reduce(workspaces, n, scale);
+}
+
+DynamicArray<uint32_t> Centrality::topNodes(const DynamicArray<float>& values, uint32_t k) {
+    DynamicArray<uint32_t> ids;
+    ids.reserve(values.size());
+    for (uint32_t i = 0; i < values.size(); ++i) {
+        ids.push_back(i);
+    }
+
+    k = std::min(k, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](uint32_t a, uint32_t b) {
+        return values.data()[a] > values.data()[b];
+    });
+
+    DynamicArray<uint32_t> top(k);
+    for (uint32_t i = 0; i < k; ++i) {
+        top.push_back(ids[i]);
+    }
+    return top;
+}
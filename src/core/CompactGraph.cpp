@@ -0,0 +1,39 @@
+#include "core/CompactGraph.hpp"
+
+CompactGraph::CompactGraph(const DynamicArray<Node>& nodos) {
+    const uint32_t n = nodos.size();
+
+    // ----- CONTAR GRADOS -----
+    _outOffsets.assign(n + 1, 0);
+    _inOffsets.assign(n + 1, 0);
+    for (const Node& node : nodos) {
+        for (const Node* target : node._output) {
+            if (!target) continue;
+            ++_outOffsets[node._id + 1];
+            ++_inOffsets[target->_id + 1];
+        }
+    }
+
+    // Prefijos acumulados
+    for (uint32_t i = 0; i < n; ++i) {
+        _outOffsets[i + 1] += _outOffsets[i];
+        _inOffsets[i + 1] += _inOffsets[i];
+    }
+
+    // ----- RELLENAR VECINOS -----
+    _outTargets.assign(_outOffsets[n], 0);
+    _inTargets.assign(_inOffsets[n], 0);
+
+    DynamicArray<uint32_t> cursor;
+    cursor.assign(n, 0);
+    for (const Node& node : nodos) {
+        uint32_t out = _outOffsets[node._id];
+        for (const Node* target : node._output) {
+            if (!target) continue;
+            _outTargets[out++] = target->_id;
+
+            uint32_t& in = cursor[target->_id];
+            _inTargets[_inOffsets[target->_id] + in++] = node._id;
+        }
+    }
+}
@@ -0,0 +1,292 @@
+#include "core/ForceLayout.hpp"
+#include "core/Arcane.hpp"
+#include "utils/ThreadPool.hpp"
+#include "utils/Trace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define FORCE_LAYOUT_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FORCE_LAYOUT_SSE2 1
+#endif
+
+namespace {
+    constexpr uint32_t POINT_GRAIN = 16384;
+    constexpr uint32_t FORCE_GRAIN = 256;           // Nodos por tarea al calcular fuerzas
+    constexpr float SOFTENING = 1e-4f;              // Evita la división por cero entre puntos coincidentes
+    constexpr float MIN_STEP = 1e-4f;               // Desplazamientos menores no mueven el nodo
+
+#if defined(FORCE_LAYOUT_AVX2)
+    constexpr uint32_t LANES = 8;
+#elif defined(FORCE_LAYOUT_SSE2)
+    constexpr uint32_t LANES = 4;
+#else
+    constexpr uint32_t LANES = 1;
+#endif
+
+    // Suma de m * (p - q) / (|p - q|² + SOFTENING) sobre la lista; count es
+    // múltiplo de LANES (el relleno tiene masa 0)
+    glm::vec3 repulsion(const float* x, const float* y, const float* z, const float* mass,
+                        uint32_t count, const glm::vec3& p) noexcept {
+#if defined(FORCE_LAYOUT_AVX2)
+        const __m256 px = _mm256_set1_ps(p.x), py = _mm256_set1_ps(p.y), pz = _mm256_set1_ps(p.z);
+        const __m256 eps = _mm256_set1_ps(SOFTENING);
+        __m256 fx = _mm256_setzero_ps(), fy = _mm256_setzero_ps(), fz = _mm256_setzero_ps();
+        for (uint32_t k = 0; k < count; k += 8) {
+            const __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(x + k));
+            const __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(y + k));
+            const __m256 dz = _mm256_sub_ps(pz, _mm256_loadu_ps(z + k));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), eps);
+            d2 = _mm256_add_ps(d2, _mm256_mul_ps(dy, dy));
+            d2 = _mm256_add_ps(d2, _mm256_mul_ps(dz, dz));
+            const __m256 w = _mm256_div_ps(_mm256_loadu_ps(mass + k), d2);
+            fx = _mm256_add_ps(fx, _mm256_mul_ps(dx, w));
+            fy = _mm256_add_ps(fy, _mm256_mul_ps(dy, w));
+            fz = _mm256_add_ps(fz, _mm256_mul_ps(dz, w));
+        }
+        alignas(32) float sx[8], sy[8], sz[8];
+        _mm256_store_ps(sx, fx); _mm256_store_ps(sy, fy); _mm256_store_ps(sz, fz);
+        glm::vec3 f(0.0f);
+        for (uint32_t l = 0; l < 8; ++l) f += glm::vec3(sx[l], sy[l], sz[l]);
+        return f;
+#elif defined(FORCE_LAYOUT_SSE2)
+        const __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y), pz = _mm_set1_ps(p.z);
+        const __m128 eps = _mm_set1_ps(SOFTENING);
+        __m128 fx = _mm_setzero_ps(), fy = _mm_setzero_ps(), fz = _mm_setzero_ps();
+        for (uint32_t k = 0; k < count; k += 4) {
+            const __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(x + k));
+            const __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(y + k));
+            const __m128 dz = _mm_sub_ps(pz, _mm_loadu_ps(z + k));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), eps);
+            d2 = _mm_add_ps(d2, _mm_mul_ps(dy, dy));
+            d2 = _mm_add_ps(d2, _mm_mul_ps(dz, dz));
+            const __m128 w = _mm_div_ps(_mm_loadu_ps(mass + k), d2);
+            fx = _mm_add_ps(fx, _mm_mul_ps(dx, w));
+            fy = _mm_add_ps(fy, _mm_mul_ps(dy, w));
+            fz = _mm_add_ps(fz, _mm_mul_ps(dz, w));
+        }
+        alignas(16) float sx[4], sy[4], sz[4];
+        _mm_store_ps(sx, fx); _mm_store_ps(sy, fy); _mm_store_ps(sz, fz);
+        return glm::vec3(sx[0] + sx[1] + sx[2] + sx[3],
+                         sy[0] + sy[1] + sy[2] + sy[3],
+                         sz[0] + sz[1] + sz[2] + sz[3]);
+#else
+        glm::vec3 f(0.0f);
+        for (uint32_t k = 0; k < count; ++k) {
+            const glm::vec3 d = p - glm::vec3(x[k], y[k], z[k]);
+            f += d * (mass[k] / (glm::dot(d, d) + SOFTENING));
+        }
+        return f;
+#endif
+    }
+}
+
+ForceLayout::ForceLayout(float radius) : _tree(radius) {}
+
+ForceLayout::ForceLayout(float radius, const Parameters& parameters)
+    : _parameters(parameters), _tree(radius) {}
+
+void ForceLayout::Interactions::add(const glm::vec3& p, float m) {
+    if (count == x.size()) {
+        const size_t grown = std::max<size_t>(64, x.size() * 2);
+        x.resize(grown); y.resize(grown); z.resize(grown); mass.resize(grown);
+    }
+    x[count] = p.x; y[count] = p.y; z[count] = p.z; mass[count] = m;
+    ++count;
+}
+
+void ForceLayout::Interactions::pad(uint32_t width) {
+    while (count % width != 0) add(glm::vec3(0.0f), 0.0f);
+}
+
+void ForceLayout::reset(const Arcane& arcane) {
+    MULTIVERSO_TRACE_SCOPE("layout", "ForceLayout::reset");
+    // Las posiciones de la red son ya del hilo de render (ver Arcane)
+    assert(!arcane.layoutApplied());
+    const auto& nodes = arcane.getNodes();
+    const uint32_t numNodes = nodes.size();
+
+    _graph = CompactGraph(nodes);
+    _initial.resize(numNodes);
+    ThreadPool::instance().parallelFor(numNodes, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) _initial[i] = nodes[i]._posicion;
+    });
+    restore();
+}
+
+void ForceLayout::restore() {
+    _positions = _initial;
+    _forces.assign(_positions.size(), glm::vec3(0.0f));
+    _temperature = _parameters.initialTemperature * _parameters.edgeLength;
+    _cursor = 0;
+    _nodeMilliseconds = 0.0;
+    _iteration = 0;
+    _tree.reorder();
+    syncIndex();
+    ++_version;
+}
+
+bool ForceLayout::converged() const noexcept {
+    return _temperature < _parameters.minTemperature * _parameters.edgeLength;
+}
+
+uint32_t ForceLayout::run(double budgetMilliseconds) {
+    const uint32_t count = size();
+    if (count == 0 || converged()) return 0;
+    MULTIVERSO_TRACE_SCOPE("layout", "ForceLayout::run");
+
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    const Clock::time_point start = Clock::now();
+    uint32_t completed = 0;
+    double remaining = budgetMilliseconds;
+    do {
+        // Tantos nodos como quepan en lo que queda, según el coste medido
+        uint32_t chunk = MIN_CHUNK_NODES;
+        if (_nodeMilliseconds > 0.0) {
+            chunk = static_cast<uint32_t>(std::min<double>(remaining / _nodeMilliseconds, count));
+            chunk = std::max(chunk, MIN_CHUNK_NODES);
+        }
+        const uint32_t end = std::min(_cursor + chunk, count);
+
+        const Clock::time_point chunkStart = Clock::now();
+        computeForces(_cursor, end);
+        _nodeMilliseconds = elapsed(chunkStart) / static_cast<double>(end - _cursor);
+
+        _cursor = end;
+        if (_cursor == count) {
+            integrate();
+            _cursor = 0;
+            ++completed;
+            if (converged()) break;
+        }
+        remaining = budgetMilliseconds - elapsed(start);
+    } while (remaining > 0.0);
+    return completed;
+}
+
+void ForceLayout::computeForces(uint32_t begin, uint32_t end) {
+    ThreadPool& pool = ThreadPool::instance();
+    if (_workspaces.size() != pool.size()) _workspaces.resize(pool.size());
+
+    const float k = _parameters.edgeLength;
+    const float k2 = k * k;
+    const float gravity = _parameters.gravity;
+    const uint32_t* order = _tree.order();
+
+    pool.parallelFor(end - begin, FORCE_GRAIN, [&](uint32_t worker, uint32_t first, uint32_t last) {
+        Interactions& list = _workspaces[worker];
+        for (uint32_t m = begin + first; m < begin + last; ++m) {
+            const uint32_t id = order[m];
+            const glm::vec3 p = _positions[id];
+
+            // Repulsión (Barnes-Hut): K² / d en la dirección que los separa
+            gather(id, list);
+            list.pad(LANES);
+            glm::vec3 force = k2 * repulsion(list.x.data(), list.y.data(), list.z.data(),
+                                             list.mass.data(), list.count, p);
+
+            // Resortes por las conexiones en ambos sentidos: d² / K hacia el vecino
+            auto spring = [&](const uint32_t* it, const uint32_t* stop) {
+                for (; it != stop; ++it) {
+                    const glm::vec3 d = _positions[*it] - p;
+                    force += d * (glm::length(d) / k);
+                }
+            };
+            spring(_graph.outBegin(id), _graph.outEnd(id));
+            spring(_graph.inBegin(id), _graph.inEnd(id));
+
+            force -= p * (gravity * k);
+            _forces[id] = force;
+        }
+    });
+}
+
+void ForceLayout::gather(uint32_t id, Interactions& list) const {
+    list.count = 0;
+    const std::vector<Octree::Cell>& cells = _tree.cells();
+    if (cells.empty()) return;
+
+    const uint32_t* order = _tree.order();
+    const glm::vec3 p = _positions[id];
+    const float theta2 = _parameters.theta * _parameters.theta;
+
+    uint32_t stack[8 * (Octree::MAX_DEPTH + 1)];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Octree::Cell& cell = cells[stack[--top]];
+        if (cell.count == 0) continue;
+
+        // Celda lejana (hoja o no): una sola masa en su centroide
+        const glm::vec3 extent = cell.hi - cell.lo;
+        const float side = std::max(extent.x, std::max(extent.y, extent.z));
+        const glm::vec3 d = cell.centroid - p;
+        if (side * side < theta2 * glm::dot(d, d)) {
+            list.add(cell.centroid, static_cast<float>(cell.count));
+        } else if (cell.childCount == 0) {
+            for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) {
+                if (order[k] != id) list.add(_positions[order[k]], 1.0f);
+            }
+        } else {
+            for (uint32_t c = 0; c < cell.childCount; ++c) stack[top++] = cell.firstChild + c;
+        }
+    }
+}
+
+void ForceLayout::integrate() {
+    const uint32_t count = size();
+    const float temperature = _temperature;
+
+    // Cada nodo avanza en la dirección de su fuerza, como mucho `temperature`
+    ThreadPool::instance().parallelFor(count, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const glm::vec3& force = _forces[i];
+            const float length = glm::length(force);
+            const float step = std::min(length, temperature);
+            if (step < MIN_STEP) continue;
+            _positions[i] += force * (step / length);
+        }
+    });
+
+    _temperature *= _parameters.cooling;
+    ++_iteration;
+    ++_version;
+
+    // El árbol se reconstruye entero: reajustar las cajas sin reordenar deja
+    // celdas solapadas que Barnes-Hut acaba abriendo casi siempre, y la
+    // construcción cuesta poco frente al cálculo de fuerzas
+    _tree.reorder();
+    syncIndex();
+}
+
+void ForceLayout::syncIndex() {
+    const uint32_t count = size();
+    glm::vec3* dst = _tree.positions(count);
+    ThreadPool::instance().parallelFor(count, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        std::copy(_positions.begin() + begin, _positions.begin() + end, dst + begin);
+    });
+    _tree.commit();
+}
+
+void ForceLayout::clear() noexcept {
+    _tree.clear();
+    _graph = CompactGraph();
+    _initial.clear();
+    _positions.clear();
+    _forces.clear();
+    _temperature = 0.0f;
+    _cursor = 0;
+    _nodeMilliseconds = 0.0;
+    _iteration = 0;
+    ++_version;
+}
@@ -0,0 +1,145 @@
+#include "core/LandmarkOracle.hpp"
+#include "core/CompactGraph.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <vector>
+
+void LandmarkOracle::build(const DynamicArray<Node>& nodos, uint32_t count, Strategy strategy) {
+    clear();
+    const uint32_t n = nodos.size();
+    if (n == 0 || count == 0) return;
+
+    const CompactGraph graph(nodos);
+
+    // ----- SELECCIONAR LANDMARKS -----
+    auto degree = [&](uint32_t id) {
+        return static_cast<uint32_t>((graph.outEnd(id) - graph.outBegin(id)) +
+                                     (graph.inEnd(id) - graph.inBegin(id)));
+    };
+
+    if (strategy == Strategy::PerLevel) {
+        uint32_t maxLevel = 0;
+        for (const Node& node : nodos) {
+            maxLevel = std::max(maxLevel, node._level);
+        }
+
+        DynamicArray<uint32_t> best;
+        best.assign(maxLevel + 1, UNREACHABLE);
+        for (const Node& node : nodos) {
+            uint32_t& current = best[node._level];
+            if (current == UNREACHABLE || degree(node._id) > degree(current)) {
+                current = node._id;
+            }
+        }
+
+        for (uint32_t id : best) {
+            if (id != UNREACHABLE && _landmarks.size() < count) {
+                _landmarks.push_back(id);
+            }
+        }
+    } else {
+        DynamicArray<uint32_t> ids;
+        ids.reserve(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            ids.push_back(i);
+        }
+
+        uint32_t k = std::min(count, n);
+        std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](uint32_t a, uint32_t b) {
+            return degree(a) > degree(b);
+        });
+        for (uint32_t i = 0; i < k; ++i) {
+            _landmarks.push_back(ids[i]);
+        }
+    }
+
+    _k = _landmarks.size();
+    _numNodes = n;
+    _forward.assign(n * _k, INF);
+    _backward.assign(n * _k, INF);
+
+    // ----- BFS EN PARALELO: 2K recorridos (adelante y atrás) -----
+    ThreadPool& pool = ThreadPool::instance();
+    std::vector<DynamicArray<uint32_t>> queues(pool.size());
+
+    pool.parallelFor(2 * _k, 1, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        DynamicArray<uint32_t>& queue = queues[worker];
+        queue.reserve(n);
+
+        for (uint32_t task = begin; task < end; ++task) {
+            const bool forward = task < _k;
+            const uint32_t l = forward ? task : task - _k;
+            uint16_t* dist = forward ? _forward.data() : _backward.data();
+
+            queue.clear();
+            queue.push_back(_landmarks[l]);
+            dist[_landmarks[l] * _k + l] = 0;
+
+            for (uint32_t head = 0; head < queue.size(); ++head) {
+                const uint32_t v = queue.data()[head];
+                const uint16_t next = static_cast<uint16_t>(std::min<uint32_t>(dist[v * _k + l] + 1u, INF - 1u));
+
+                const uint32_t* it = forward ? graph.outBegin(v) : graph.inBegin(v);
+                const uint32_t* last = forward ? graph.outEnd(v) : graph.inEnd(v);
+                for (; it != last; ++it) {
+                    uint16_t& d = dist[*it * _k + l];
+                    if (d == INF) {
+                        d = next;
+                        queue.push_back(*it);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void LandmarkOracle::clear() noexcept {
+    _numNodes = 0;
+    _k = 0;
+    _landmarks.clear();
+    _forward.clear();
+    _backward.clear();
+}
+
+LandmarkOracle::Bounds LandmarkOracle::bounds(uint32_t a, uint32_t b) const noexcept {
+    Bounds result;
+    if (a >= _numNodes || b >= _numNodes) return result;
+    if (a == b) return {0, 0};
+
+    const uint16_t* fa = _forward.data() + a * _k;
+    const uint16_t* fb = _forward.data() + b * _k;
+    const uint16_t* ba = _backward.data() + a * _k;
+    const uint16_t* bb = _backward.data() + b * _k;
+
+    uint32_t lower = 1;
+    for (uint32_t l = 0; l < _k; ++l) {
+        // d(L,b) <= d(L,a) + d(a,b): si L llega a `a` pero no a `b`, b es inalcanzable
+        if (fa[l] != INF && fb[l] == INF) return {UNREACHABLE, UNREACHABLE};
+        // d(a,L) <= d(a,b) + d(b,L): si `b` llega a L pero `a` no, b es inalcanzable
+        if (ba[l] == INF && bb[l] != INF) return {UNREACHABLE, UNREACHABLE};
+
+        if (fa[l] != INF && fb[l] > fa[l]) lower = std::max<uint32_t>(lower, fb[l] - fa[l]);
+        if (bb[l] != INF && ba[l] > bb[l]) lower = std::max<uint32_t>(lower, ba[l] - bb[l]);
+        if (ba[l] != INF && fb[l] != INF) result.upper = std::min<uint32_t>(result.upper, ba[l] + fb[l]);
+    }
+
+    result.lower = lower;
+    return result;
+}
+
+uint32_t LandmarkOracle::lowerBound(uint32_t a, uint32_t b) const noexcept {
+    if (a == b || a >= _numNodes || b >= _numNodes) return 0;
+
+    const uint16_t* fa = _forward.data() + a * _k;
+    const uint16_t* fb = _forward.data() + b * _k;
+    const uint16_t* ba = _backward.data() + a * _k;
+    const uint16_t* bb = _backward.data() + b * _k;
+
+    uint32_t lower = 0;
+    for (uint32_t l = 0; l < _k; ++l) {
+        if (fa[l] != INF && fb[l] != INF && fb[l] > fa[l]) lower = std::max<uint32_t>(lower, fb[l] - fa[l]);
+        if (ba[l] != INF && bb[l] != INF && ba[l] > bb[l]) lower = std::max<uint32_t>(lower, ba[l] - bb[l]);
+    }
+    return lower;
+}
@@ -0,0 +1,420 @@
+#include "core/Octree.hpp"
+#include "core/Arcane.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    constexpr uint32_t POINT_GRAIN = 16384;
+    constexpr uint32_t CELL_GRAIN = 256;
+
+    // Separa los 10 bits bajos de v dejando dos ceros entre cada uno
+    uint32_t expandBits(uint32_t v) noexcept {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    uint32_t mortonCode(const glm::vec3& unit) noexcept {
+        auto quantize = [](float x) {
+            return static_cast<uint32_t>(std::clamp(x * 1024.0f, 0.0f, 1023.0f));
+        };
+        return (expandBits(quantize(unit.x)) << 2) | (expandBits(quantize(unit.y)) << 1) |
+               expandBits(quantize(unit.z));
+    }
+
+    // Octante de la clave a una profundidad: 3 bits del código, de los altos a los bajos
+    uint32_t octant(uint64_t key, uint32_t depth) noexcept {
+        return static_cast<uint32_t>(key >> (32 + 3 * (Octree::MAX_DEPTH - 1 - depth))) & 7u;
+    }
+
+    // Octantes ocupados de [begin, end) (claves ordenadas con el mismo prefijo):
+    // escribe el inicio de cada uno en `starts` y devuelve cuántos son
+    uint32_t splitOctants(const uint64_t* keys, uint32_t begin, uint32_t end, uint32_t depth,
+                          uint32_t* starts) noexcept {
+        uint32_t runs = 0;
+        while (begin < end) {
+            const uint32_t current = octant(keys[begin], depth);
+            starts[runs++] = begin;
+            begin = static_cast<uint32_t>(std::partition_point(keys + begin, keys + end, [&](uint64_t key) {
+                return octant(key, depth) <= current;
+            }) - keys);
+        }
+        return runs;
+    }
+
+    // Ordenación en paralelo: bloques ordenados por separado y mezclas por
+    // parejas, cada ronda repartida entre los hilos
+    void parallelSort(std::vector<uint64_t>& keys) {
+        ThreadPool& pool = ThreadPool::instance();
+        const uint32_t count = static_cast<uint32_t>(keys.size());
+        const uint32_t chunk = std::max((count + pool.size() - 1) / pool.size(), POINT_GRAIN);
+        const uint32_t chunks = (count + chunk - 1) / chunk;
+
+        pool.parallelFor(chunks, 1, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t c = begin; c < end; ++c) {
+                std::sort(keys.begin() + c * chunk, keys.begin() + std::min(count, (c + 1) * chunk));
+            }
+        });
+        for (uint32_t width = chunk; width < count; width *= 2) {
+            const uint32_t pairs = (count + 2 * width - 1) / (2 * width);
+            pool.parallelFor(pairs, 1, [&](uint32_t, uint32_t begin, uint32_t end) {
+                for (uint32_t p = begin; p < end; ++p) {
+                    const uint32_t first = p * 2 * width;
+                    const uint32_t middle = std::min(count, first + width);
+                    const uint32_t last = std::min(count, first + 2 * width);
+                    std::inplace_merge(keys.begin() + first, keys.begin() + middle, keys.begin() + last);
+                }
+            });
+        }
+    }
+}
+
+// ----- Formas de consulta -----
+
+Octree::Overlap Octree::Sphere::overlap(const glm::vec3& lo, const glm::vec3& hi) const noexcept {
+    // Punto de la caja más cercano y esquina más lejana
+    const glm::vec3 nearest = glm::clamp(center, lo, hi);
+    const glm::vec3 nearDelta = nearest - center;
+    const float squared = radius * radius;
+    if (glm::dot(nearDelta, nearDelta) > squared) return Overlap::Outside;
+
+    const glm::vec3 farDelta = glm::max(glm::abs(lo - center), glm::abs(hi - center));
+    return glm::dot(farDelta, farDelta) <= squared ? Overlap::Inside : Overlap::Intersects;
+}
+
+bool Octree::Sphere::contains(const glm::vec3& p) const noexcept {
+    const glm::vec3 delta = p - center;
+    return glm::dot(delta, delta) <= radius * radius;
+}
+
+Octree::Overlap Octree::Box::overlap(const glm::vec3& cellLo, const glm::vec3& cellHi) const noexcept {
+    if (cellHi.x < lo.x || cellHi.y < lo.y || cellHi.z < lo.z ||
+        cellLo.x > hi.x || cellLo.y > hi.y || cellLo.z > hi.z) {
+        return Overlap::Outside;
+    }
+    const bool inside = cellLo.x >= lo.x && cellLo.y >= lo.y && cellLo.z >= lo.z &&
+                        cellHi.x <= hi.x && cellHi.y <= hi.y && cellHi.z <= hi.z;
+    return inside ? Overlap::Inside : Overlap::Intersects;
+}
+
+bool Octree::Box::contains(const glm::vec3& p) const noexcept {
+    return p.x >= lo.x && p.y >= lo.y && p.z >= lo.z && p.x <= hi.x && p.y <= hi.y && p.z <= hi.z;
+}
+
+// ----- Construcción y reajuste -----
+
+glm::vec3* Octree::positions(uint32_t count) {
+    if (count != _positions.size()) {
+        _positions.resize(count);
+        _ordered = false;
+    }
+    return _positions.data();
+}
+
+void Octree::commit() {
+    if (!_ordered) {
+        build();
+        _ordered = true;
+    }
+    refit(true);
+}
+
+void Octree::commit(uint32_t begin, uint32_t end) {
+    if (!_ordered) {
+        commit();
+        return;
+    }
+    end = std::min(end, size());
+    if (begin >= end) return;
+
+    _dirty.assign(_cells.size(), 0);
+    for (uint32_t id = begin; id < end; ++id) _dirty[_leafOf[id]] = 1;
+    refit(false);
+}
+
+void Octree::build() {
+    ThreadPool& pool = ThreadPool::instance();
+    const uint32_t count = size();
+    _cells.clear();
+    _levels.clear();
+    _keys.resize(count);
+    _order.resize(count);
+    _leafOf.resize(count);
+    if (count == 0) return;
+
+    // Cubo envolvente (mínimos y máximos por hilo) para normalizar las coordenadas
+    std::vector<glm::vec3> lows(pool.size(), _positions[0]);
+    std::vector<glm::vec3> highs(pool.size(), _positions[0]);
+    pool.parallelFor(count, POINT_GRAIN, [&](uint32_t worker, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            lows[worker] = glm::min(lows[worker], _positions[i]);
+            highs[worker] = glm::max(highs[worker], _positions[i]);
+        }
+    });
+    glm::vec3 lo = lows[0], hi = highs[0];
+    for (uint32_t w = 1; w < pool.size(); ++w) {
+        lo = glm::min(lo, lows[w]);
+        hi = glm::max(hi, highs[w]);
+    }
+    const glm::vec3 center = (lo + hi) * 0.5f;
+    const glm::vec3 span = hi - lo;
+    const float extent = std::max(std::max(span.x, span.y), std::max(span.z, 1e-6f));
+    lo = center - extent * 0.5f;
+
+    // Clave (Morton << 32 | id): una sola ordenación trae los ids
+    pool.parallelFor(count, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const glm::vec3 unit = (_positions[i] - lo) / extent;
+            _keys[i] = (static_cast<uint64_t>(mortonCode(unit)) << 32) | i;
+        }
+    });
+    parallelSort(_keys);
+    pool.parallelFor(count, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t k = begin; k < end; ++k) _order[k] = static_cast<uint32_t>(_keys[k]);
+    });
+
+    // Nivel a nivel: contar los hijos de cada celda, suma de prefijos y escribirlos
+    Cell root;
+    root.count = count;
+    _cells.push_back(root);
+    _levels.push_back(0);
+    std::vector<uint32_t> offsets;
+    uint32_t levelBegin = 0;
+    uint32_t levelEnd = 1;
+    while (true) {
+        const uint32_t width = levelEnd - levelBegin;
+        offsets.resize(width + 1);
+        pool.parallelFor(width, CELL_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+            uint32_t starts[8];
+            for (uint32_t c = begin; c < end; ++c) {
+                const Cell& cell = _cells[levelBegin + c];
+                const bool split = cell.count > LEAF_SIZE && cell.depth < MAX_DEPTH;
+                offsets[c] = split ? splitOctants(_keys.data(), cell.begin, cell.begin + cell.count,
+                                                  cell.depth, starts)
+                                   : 0;
+            }
+        });
+
+        uint32_t total = 0;
+        for (uint32_t c = 0; c < width; ++c) {
+            const uint32_t children = offsets[c];
+            offsets[c] = total;
+            total += children;
+        }
+        offsets[width] = total;
+        if (total == 0) break;
+
+        _cells.resize(levelEnd + total);
+        pool.parallelFor(width, CELL_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+            uint32_t starts[9];
+            for (uint32_t c = begin; c < end; ++c) {
+                Cell& cell = _cells[levelBegin + c];
+                const uint32_t children = offsets[c + 1] - offsets[c];
+                if (children == 0) continue;
+
+                splitOctants(_keys.data(), cell.begin, cell.begin + cell.count, cell.depth, starts);
+                starts[children] = cell.begin + cell.count;
+                cell.firstChild = levelEnd + offsets[c];
+                cell.childCount = static_cast<uint8_t>(children);
+                for (uint32_t j = 0; j < children; ++j) {
+                    Cell& child = _cells[cell.firstChild + j];
+                    child = Cell();
+                    child.begin = starts[j];
+                    child.count = starts[j + 1] - starts[j];
+                    child.depth = static_cast<uint8_t>(cell.depth + 1);
+                }
+            }
+        });
+        _levels.push_back(levelEnd);
+        levelBegin = levelEnd;
+        levelEnd += total;
+    }
+    _levels.push_back(levelEnd);
+
+    // Hoja de cada id, para los reajustes parciales
+    const uint32_t numCells = static_cast<uint32_t>(_cells.size());
+    pool.parallelFor(numCells, CELL_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            const Cell& cell = _cells[c];
+            if (cell.childCount != 0) continue;
+            for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) _leafOf[_order[k]] = c;
+        }
+    });
+}
+
+void Octree::refitCell(Cell& cell) noexcept {
+    if (cell.childCount == 0) {
+        const glm::vec3& first = _positions[_order[cell.begin]];
+        glm::vec3 lo = first, hi = first, sum(0.0f);
+        for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) {
+            const glm::vec3& p = _positions[_order[k]];
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+            sum += p;
+        }
+        cell.lo = lo - _radius;
+        cell.hi = hi + _radius;
+        cell.centroid = sum / static_cast<float>(cell.count);
+        return;
+    }
+
+    const Cell& first = _cells[cell.firstChild];
+    glm::vec3 lo = first.lo, hi = first.hi, sum(0.0f);
+    for (uint32_t j = 0; j < cell.childCount; ++j) {
+        const Cell& child = _cells[cell.firstChild + j];
+        lo = glm::min(lo, child.lo);
+        hi = glm::max(hi, child.hi);
+        sum += child.centroid * static_cast<float>(child.count);
+    }
+    cell.lo = lo;
+    cell.hi = hi;
+    cell.centroid = sum / static_cast<float>(cell.count);
+}
+
+void Octree::refit(bool all) {
+    if (_cells.empty()) return;
+
+    // De las hojas a la raíz: cada nivel depende solo del siguiente
+    ThreadPool& pool = ThreadPool::instance();
+    for (size_t level = _levels.size() - 1; level-- > 0;) {
+        const uint32_t first = _levels[level];
+        pool.parallelFor(_levels[level + 1] - first, CELL_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t c = first + begin; c < first + end; ++c) {
+                Cell& cell = _cells[c];
+                if (!all) {
+                    bool moved = _dirty[c] != 0;
+                    for (uint32_t j = 0; j < cell.childCount && !moved; ++j) moved = _dirty[cell.firstChild + j] != 0;
+                    if (!moved) continue;
+                    _dirty[c] = 1;
+                }
+                refitCell(cell);
+            }
+        });
+    }
+}
+
+void Octree::update(const Arcane& arcane) {
+    // Las posiciones de la red son ya del hilo de render (ver Arcane)
+    assert(!arcane.layoutApplied());
+    const InstanceVersion& source = arcane.getInstanceVersion(InstanceData::NodePositions);
+    const uint32_t numNodes = arcane.getNumNodes();
+    const bool sameNetwork = _ordered && _network == arcane.getVersion() && size() == numNodes;
+    if (sameNetwork && source.version == _version) return;
+
+    // Mismo criterio que la subida por versiones del renderer
+    const Node* nodes = arcane.getNodes().data();
+    if (sameNetwork && _version >= source.base) {
+        const uint32_t begin = std::min(source.dirty.begin, numNodes);
+        const uint32_t end = std::min(source.dirty.end, numNodes);
+        for (uint32_t i = begin; i < end; ++i) _positions[i] = nodes[i]._posicion;
+        commit(begin, end);
+    } else {
+        if (!sameNetwork) reorder();
+        glm::vec3* dst = positions(numNodes);
+        ThreadPool::instance().parallelFor(numNodes, POINT_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) dst[i] = nodes[i]._posicion;
+        });
+        commit();
+    }
+    _network = arcane.getVersion();
+    _version = source.version;
+}
+
+// ----- Consultas -----
+
+Octree::Hit Octree::pick(const glm::vec3& origin, const glm::vec3& direction) const noexcept {
+    Hit hit;
+    if (_cells.empty() || _cells[0].count == 0) return hit;
+
+    const glm::vec3 dir = glm::normalize(direction);
+    const glm::vec3 inverse = 1.0f / dir;           // ±inf en ejes paralelos: el test de slabs lo admite
+    const float squared = _radius * _radius;
+    float best = INFINITY;
+
+    // Entrada del rayo en la caja, o infinito si no la corta antes de `best`
+    auto enter = [&](const Cell& cell) {
+        const glm::vec3 t0 = (cell.lo - origin) * inverse;
+        const glm::vec3 t1 = (cell.hi - origin) * inverse;
+        const glm::vec3 lower = glm::min(t0, t1);
+        const glm::vec3 upper = glm::max(t0, t1);
+        const float tEnter = std::max(std::max(lower.x, lower.y), std::max(lower.z, 0.0f));
+        const float tExit = std::min(std::min(upper.x, upper.y), upper.z);
+        return (tEnter <= tExit && tEnter < best) ? tEnter : INFINITY;
+    };
+
+    uint32_t stack[8 * (MAX_DEPTH + 1)];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = _cells[stack[--top]];
+        if (enter(cell) == INFINITY) continue;
+
+        if (cell.childCount == 0) {
+            // Esfera: |o + t d - p|² = r² con d normalizada
+            for (uint32_t k = cell.begin; k < cell.begin + cell.count; ++k) {
+                const glm::vec3 offset = origin - _positions[_order[k]];
+                const float b = glm::dot(offset, dir);
+                const float c = glm::dot(offset, offset) - squared;
+                const float discriminant = b * b - c;
+                if (discriminant < 0.0f) continue;
+                const float root = std::sqrt(discriminant);
+                const float t = (-b - root >= 0.0f) ? -b - root : -b + root;
+                if (t >= 0.0f && t < best) {
+                    best = t;
+                    hit.id = _order[k];
+                }
+            }
+            continue;
+        }
+
+        // Los hijos más cercanos al final de la pila para que se prueben antes
+        float entries[8];
+        uint32_t children[8];
+        uint32_t pending = 0;
+        for (uint32_t j = 0; j < cell.childCount; ++j) {
+            const float t = enter(_cells[cell.firstChild + j]);
+            if (t == INFINITY) continue;
+            uint32_t slot = pending++;
+            while (slot > 0 && entries[slot - 1] < t) {
+                entries[slot] = entries[slot - 1];
+                children[slot] = children[slot - 1];
+                --slot;
+            }
+            entries[slot] = t;
+            children[slot] = cell.firstChild + j;
+        }
+        for (uint32_t j = 0; j < pending; ++j) stack[top++] = children[j];
+    }
+    hit.distance = best;
+    return hit;
+}
+
+uint32_t Octree::queryRadius(const glm::vec3& center, float radius, DynamicArray<uint32_t>& out) const {
+    const uint32_t before = out.size();
+    query(Sphere{center, radius}, [&](uint32_t id) { out.push_back(id); });
+    return out.size() - before;
+}
+
+uint32_t Octree::queryBox(const glm::vec3& lo, const glm::vec3& hi, DynamicArray<uint32_t>& out) const {
+    const uint32_t before = out.size();
+    query(Box{lo, hi}, [&](uint32_t id) { out.push_back(id); });
+    return out.size() - before;
+}
+
+void Octree::clear() noexcept {
+    _positions.clear();
+    _keys.clear();
+    _order.clear();
+    _leafOf.clear();
+    _cells.clear();
+    _levels.clear();
+    _dirty.clear();
+    _ordered = false;
+    _network = 0;
+    _version = 0;
+}
@@ -0,0 +1,86 @@
+#include "core/PathCache.hpp"
+
+#include <utility>
+
+PathCache::PathCache(uint32_t capacity, uint32_t treeCapacity) {
+    _entries.reserve(capacity);
+    for (uint32_t i = 0; i < capacity; ++i) {
+        _entries.push_back(Entry());
+    }
+
+    _trees.reserve(treeCapacity);
+    for (uint32_t i = 0; i < treeCapacity; ++i) {
+        _trees.push_back(Tree());
+    }
+}
+
+const DynamicArray<uint32_t>* PathCache::find(uint64_t version, uint32_t origen, uint32_t destino, uint8_t mode) {
+    for (Entry& entry : _entries) {
+        if (entry.valid && entry.version == version && entry.origen == origen &&
+            entry.destino == destino && entry.mode == mode) {
+            entry.lastUse = ++_tick;
+            ++_stats.hits;
+            return &entry.path;
+        }
+    }
+    return nullptr;
+}
+
+void PathCache::insert(uint64_t version, uint32_t origen, uint32_t destino, uint8_t mode,
+                       DynamicArray<uint32_t>&& path) {
+    if (_entries.empty()) return;
+
+    // Ranura libre u obsoleta, o la menos usada recientemente
+    Entry* victim = &_entries[0];
+    for (Entry& entry : _entries) {
+        if (!entry.valid || entry.version != version) {
+            victim = &entry;
+            break;
+        }
+        if (entry.lastUse < victim->lastUse) victim = &entry;
+    }
+
+    victim->version = version;
+    victim->lastUse = ++_tick;
+    victim->origen = origen;
+    victim->destino = destino;
+    victim->mode = mode;
+    victim->valid = true;
+    victim->path = std::move(path);
+}
+
+const DynamicArray<int32_t>* PathCache::findTree(uint64_t version, uint32_t origen) {
+    for (Tree& tree : _trees) {
+        if (tree.valid && tree.version == version && tree.origen == origen) {
+            tree.lastUse = ++_tick;
+            return &tree.parent;
+        }
+    }
+    return nullptr;
+}
+
+DynamicArray<int32_t>& PathCache::insertTree(uint64_t version, uint32_t origen) {
+    Tree* victim = &_trees[0];
+    for (Tree& tree : _trees) {
+        if (!tree.valid || tree.version != version) {
+            victim = &tree;
+            break;
+        }
+        if (tree.lastUse < victim->lastUse) victim = &tree;
+    }
+
+    victim->version = version;
+    victim->lastUse = ++_tick;
+    victim->origen = origen;
+    victim->valid = true;
+    return victim->parent;     // Se reutiliza la memoria del árbol expulsado
+}
+
+void PathCache::clear() noexcept {
+    for (Entry& entry : _entries) {
+        entry.valid = false;
+    }
+    for (Tree& tree : _trees) {
+        tree.valid = false;
+    }
+}
@@ -0,0 +1,269 @@
+#include "graphics/EdgeBundler.hpp"
+#include "core/Arcane.hpp"
+#include "core/ArrowKernel.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+namespace {
+    constexpr uint32_t EXPAND_GRAIN = 16384;
+
+    uint64_t bundleKey(uint32_t origin, uint32_t destination) noexcept {
+        return (static_cast<uint64_t>(origin) << 32) | destination;
+    }
+}
+
+uint32_t EdgeBundler::cellOf(uint32_t level, const glm::vec3& position) const noexcept {
+    const float length = glm::length(position);
+    if (length < 1e-6f) return std::min(level, _levels - 1) * CELLS_PER_SHELL;
+
+    // Latitud desde +Y y longitud en el plano XZ, como en assign3DPositions
+    const float polar = std::acos(std::clamp(position.y / length, -1.0f, 1.0f)) / glm::pi<float>();
+    const float azimuth = (std::atan2(position.z, position.x) + glm::pi<float>()) / glm::two_pi<float>();
+    const uint32_t stack = std::min(static_cast<uint32_t>(polar * STACKS), STACKS - 1);
+    const uint32_t sector = std::min(static_cast<uint32_t>(azimuth * SECTORS), SECTORS - 1);
+    return std::min(level, _levels - 1) * CELLS_PER_SHELL + stack * SECTORS + sector;
+}
+
+void EdgeBundler::update(const Arcane& arcane) {
+    const InstanceVersion& positions = arcane.getInstanceVersion(InstanceData::NodePositions);
+    const InstanceVersion& colors = arcane.getInstanceVersion(InstanceData::ArrowColors);
+
+    if (arcane.getVersion() != _network || _nodeCell.size() != arcane.getNumNodes() ||
+        _arrowBundle.size() != arcane.getNumArrows()) {
+        rebuild(arcane);
+        _network = arcane.getVersion();
+        _positions = positions.version;
+        _colors = colors.version;
+        return;
+    }
+
+    // Mismo criterio que la subida por versiones del renderer
+    if (positions.version != _positions) {
+        if (_positions >= positions.base) {
+            moveNodes(arcane, positions.dirty.begin, std::min(positions.dirty.end, arcane.getNumNodes()));
+        } else {
+            moveNodes(arcane, 0, arcane.getNumNodes());
+        }
+        _positions = positions.version;
+    }
+
+    // Las sumas de color se rehacen enteras: el color anterior no se guarda
+    if (colors.version != _colors) {
+        recolor(arcane);
+        _colors = colors.version;
+    }
+}
+
+void EdgeBundler::rebuild(const Arcane& arcane) {
+    const auto& nodes = arcane.getNodes();
+    const auto& arrows = arcane.getArrows();
+    const uint32_t numNodes = nodes.size();
+    const uint32_t numArrows = arrows.size();
+
+    _levels = std::max(arcane.getNumLevels(), 1u);
+    _cells.assign(static_cast<size_t>(_levels) * CELLS_PER_SHELL, Cell());
+    _open.assign(_cells.size(), 0);
+
+    _nodeCell.resize(numNodes);
+    _nodePosition.resize(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        const Node& node = nodes[i];
+        _nodePosition[i] = node._posicion;
+        _nodeCell[i] = cellOf(node._level, node._posicion);
+        Cell& cell = _cells[_nodeCell[i]];
+        cell.sum += node._posicion;
+        ++cell.count;
+    }
+
+    // Incidencia nodo -> flechas para recolocar solo las de los nodos movidos
+    _arrowOrigin.resize(numArrows);
+    _arrowDestination.resize(numArrows);
+    _incidenceFirst.assign(static_cast<size_t>(numNodes) + 1, 0);
+    for (uint32_t a = 0; a < numArrows; ++a) {
+        _arrowOrigin[a] = arrows[a]._origen->_id;
+        _arrowDestination[a] = arrows[a]._destino->_id;
+        ++_incidenceFirst[_arrowOrigin[a] + 1];
+        if (_arrowDestination[a] != _arrowOrigin[a]) ++_incidenceFirst[_arrowDestination[a] + 1];
+    }
+    for (uint32_t i = 0; i < numNodes; ++i) _incidenceFirst[i + 1] += _incidenceFirst[i];
+    _incidence.resize(_incidenceFirst[numNodes]);
+    {
+        std::vector<uint32_t> filled(_incidenceFirst.begin(), _incidenceFirst.end() - 1);
+        for (uint32_t a = 0; a < numArrows; ++a) {
+            _incidence[filled[_arrowOrigin[a]]++] = a;
+            if (_arrowDestination[a] != _arrowOrigin[a]) _incidence[filled[_arrowDestination[a]]++] = a;
+        }
+    }
+
+    _bundles.clear();
+    _bundleIndex.clear();
+    _activeBundles = 0;
+    _arrowBundle.resize(numArrows);
+    for (uint32_t a = 0; a < numArrows; ++a) {
+        addArrow(a, arrows[a]._color);
+    }
+}
+
+void EdgeBundler::moveNodes(const Arcane& arcane, uint32_t begin, uint32_t end) {
+    const auto& nodes = arcane.getNodes();
+    const auto& arrows = arcane.getArrows();
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const glm::vec3& position = nodes[i]._posicion;
+        if (position == _nodePosition[i]) continue;
+
+        // Sacar sus flechas con la posición anterior y volver a meterlas con
+        // la nueva; si el otro extremo también se movió, se repite al llegar a él
+        for (uint32_t k = _incidenceFirst[i]; k < _incidenceFirst[i + 1]; ++k) {
+            removeArrow(_incidence[k], arrows[_incidence[k]]._color);
+        }
+
+        Cell& previous = _cells[_nodeCell[i]];
+        previous.sum -= _nodePosition[i];
+        --previous.count;
+        _nodePosition[i] = position;
+        _nodeCell[i] = cellOf(nodes[i]._level, position);
+        Cell& cell = _cells[_nodeCell[i]];
+        cell.sum += position;
+        ++cell.count;
+
+        for (uint32_t k = _incidenceFirst[i]; k < _incidenceFirst[i + 1]; ++k) {
+            addArrow(_incidence[k], arrows[_incidence[k]]._color);
+        }
+    }
+}
+
+void EdgeBundler::recolor(const Arcane& arcane) {
+    const auto& arrows = arcane.getArrows();
+    for (Bundle& bundle : _bundles) bundle.colorSum = glm::vec3(0.0f);
+    for (uint32_t a = 0; a < _arrowBundle.size(); ++a) {
+        _bundles[_arrowBundle[a]].colorSum += arrows[a]._color;
+    }
+}
+
+void EdgeBundler::addArrow(uint32_t arrow, const glm::vec3& color) {
+    const uint32_t origin = _arrowOrigin[arrow];
+    const uint32_t destination = _arrowDestination[arrow];
+    const uint64_t key = bundleKey(_nodeCell[origin], _nodeCell[destination]);
+
+    auto [it, inserted] = _bundleIndex.try_emplace(key, static_cast<uint32_t>(_bundles.size()));
+    if (inserted) {
+        Bundle bundle;
+        bundle.origin = _nodeCell[origin];
+        bundle.destination = _nodeCell[destination];
+        _bundles.push_back(bundle);
+    }
+
+    Bundle& bundle = _bundles[it->second];
+    if (bundle.count++ == 0) ++_activeBundles;
+    bundle.originSum += _nodePosition[origin];
+    bundle.destinationSum += _nodePosition[destination];
+    bundle.colorSum += color;
+    _arrowBundle[arrow] = it->second;
+}
+
+void EdgeBundler::removeArrow(uint32_t arrow, const glm::vec3& color) {
+    Bundle& bundle = _bundles[_arrowBundle[arrow]];
+    bundle.originSum -= _nodePosition[_arrowOrigin[arrow]];
+    bundle.destinationSum -= _nodePosition[_arrowDestination[arrow]];
+    bundle.colorSum -= color;
+
+    // Vacío: se conserva en el mapa para reutilizarlo, con las sumas a cero
+    // para no arrastrar error de redondeo
+    if (--bundle.count == 0) {
+        --_activeBundles;
+        bundle.originSum = bundle.destinationSum = bundle.colorSum = glm::vec3(0.0f);
+    }
+}
+
+uint32_t EdgeBundler::expand(const glm::vec3& eye, const uint32_t* ids, uint32_t count) {
+    // Celdas abiertas: la cámara a menos de OPEN_DISTANCE veces su tamaño
+    const float cellAngle = glm::pi<float>() / static_cast<float>(STACKS);
+    for (size_t c = 0; c < _cells.size(); ++c) {
+        const Cell& cell = _cells[c];
+        if (cell.count == 0) {
+            _open[c] = 0;
+            continue;
+        }
+        const glm::vec3 centroid = cell.sum / static_cast<float>(cell.count);
+        const float size = std::max(glm::length(centroid), 1.0f) * cellAngle;
+        _open[c] = glm::length(eye - centroid) < OPEN_DISTANCE * size;
+    }
+
+    // Partición estable en paralelo: sueltas delante, en su orden
+    uint8_t* levels = _partition.levels(count);
+    ThreadPool::instance().parallelFor(count, EXPAND_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Bundle& bundle = _bundles[_arrowBundle[ids ? ids[i] : i]];
+            levels[i] = (_open[bundle.origin] || _open[bundle.destination]) ? 0 : 1;
+        }
+    });
+    _partition.bin(ids);
+
+    // Haces cerrados: los que tienen flechas y no tocan una celda abierta
+    _collapsed.clear();
+    _collapsedArrows = 0;
+    for (auto& end : _ends) end.clear();
+    for (uint32_t b = 0; b < _bundles.size(); ++b) {
+        const Bundle& bundle = _bundles[b];
+        if (bundle.count == 0 || _open[bundle.origin] || _open[bundle.destination]) continue;
+        _collapsed.push_back(b);
+        _collapsedArrows += bundle.count;
+
+        const float inverse = 1.0f / static_cast<float>(bundle.count);
+        const glm::vec3 origin = bundle.originSum * inverse;
+        const glm::vec3 destination = bundle.destinationSum * inverse;
+        for (int axis = 0; axis < 3; ++axis) {
+            _ends[axis].push_back(origin[axis]);
+            _ends[3 + axis].push_back(destination[axis]);
+        }
+    }
+    return _partition.count(0);
+}
+
+void EdgeBundler::writeTransforms(glm::mat4* dst) const noexcept {
+    const uint32_t count = collapsedCount();
+    const ArrowKernel::Endpoints endpoints{_ends[0].data(), _ends[1].data(), _ends[2].data(),
+                                           _ends[3].data(), _ends[4].data(), _ends[5].data()};
+    ArrowKernel::computeTransforms(endpoints, count, dst);
+
+    // Grosor según las flechas del haz: escalar X e Y locales de la malla
+    // equivale al parámetro thickness de Arrow::updateTransform
+    for (uint32_t i = 0; i < count; ++i) {
+        const float width = std::min(std::sqrt(static_cast<float>(_bundles[_collapsed[i]].count)), MAX_WIDTH);
+        dst[i][0] *= width;
+        dst[i][1] *= width;
+    }
+}
+
+void EdgeBundler::writeColors(glm::vec3* dst) const noexcept {
+    for (uint32_t i = 0; i < collapsedCount(); ++i) {
+        const Bundle& bundle = _bundles[_collapsed[i]];
+        dst[i] = bundle.colorSum / static_cast<float>(bundle.count);
+    }
+}
+
+void EdgeBundler::clear() noexcept {
+    _network = _positions = _colors = 0;
+    _levels = 0;
+    _cells.clear();
+    _open.clear();
+    _nodeCell.clear();
+    _nodePosition.clear();
+    _arrowOrigin.clear();
+    _arrowDestination.clear();
+    _arrowBundle.clear();
+    _incidenceFirst.clear();
+    _incidence.clear();
+    _bundles.clear();
+    _bundleIndex.clear();
+    _activeBundles = 0;
+    _partition.clear();
+    _collapsed.clear();
+    _collapsedArrows = 0;
+    for (auto& end : _ends) end.clear();
+}
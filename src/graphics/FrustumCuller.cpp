@@ -0,0 +1,213 @@
+#include "graphics/FrustumCuller.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr uint32_t CLUSTER_GRAIN = 64;      // Clusters por bloque del pool
+
+    // Separa los 10 bits bajos de v dejando dos ceros entre cada uno
+    uint32_t expandBits(uint32_t v) noexcept {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    uint32_t mortonCode(const glm::vec3& unit) noexcept {
+        auto quantize = [](float x) {
+            return static_cast<uint32_t>(std::clamp(x * 1024.0f, 0.0f, 1023.0f));
+        };
+        return (expandBits(quantize(unit.x)) << 2) | (expandBits(quantize(unit.y)) << 1) |
+               expandBits(quantize(unit.z));
+    }
+}
+
+// ----- Frustum -----
+
+Frustum Frustum::fromMatrix(const glm::mat4& m) noexcept {
+    // Filas de la matriz (glm guarda por columnas)
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;    // Izquierda
+    frustum.planes[1] = row3 - row0;    // Derecha
+    frustum.planes[2] = row3 + row1;    // Abajo
+    frustum.planes[3] = row3 - row1;    // Arriba
+    frustum.planes[4] = row3 + row2;    // Cerca
+    frustum.planes[5] = row3 - row2;    // Lejos
+
+    for (glm::vec4& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+    return frustum;
+}
+
+Frustum::Result Frustum::classify(const glm::vec4& sphere) const noexcept {
+    const glm::vec3 center(sphere);
+    Result result = Result::Inside;
+    for (const glm::vec4& plane : planes) {
+        float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        if (distance < -sphere.w) return Result::Outside;
+        if (distance < sphere.w) result = Result::Intersects;
+    }
+    return result;
+}
+
+// ----- FrustumCuller -----
+
+glm::vec4* FrustumCuller::spheres(uint32_t count) {
+    if (count != _spheres.size()) {
+        _spheres.resize(count);
+        _ordered = false;
+    }
+    return _spheres.data();
+}
+
+void FrustumCuller::commit() {
+    if (!_ordered) {
+        buildOrder();
+        _ordered = true;
+    }
+    refitClusters();
+}
+
+void FrustumCuller::buildOrder() {
+    const uint32_t count = size();
+
+    // Caja envolvente de los centros para normalizar las coordenadas
+    glm::vec3 lo(0.0f), hi(0.0f);
+    if (count > 0) {
+        lo = hi = glm::vec3(_spheres[0]);
+        for (const glm::vec4& sphere : _spheres) {
+            lo = glm::min(lo, glm::vec3(sphere));
+            hi = glm::max(hi, glm::vec3(sphere));
+        }
+    }
+    const glm::vec3 extent = glm::max(hi - lo, glm::vec3(1e-6f));
+
+    // Clave (Morton << 32 | id): una sola ordenación trae los ids
+    std::vector<uint64_t> keys(count);
+    ThreadPool::instance().parallelFor(count, 16384, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const glm::vec3 unit = (glm::vec3(_spheres[i]) - lo) / extent;
+            keys[i] = (static_cast<uint64_t>(mortonCode(unit)) << 32) | i;
+        }
+    });
+    std::sort(keys.begin(), keys.end());
+
+    _order.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        _order[i] = static_cast<uint32_t>(keys[i]);
+    }
+
+    const uint32_t numClusters = (count + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    _clusters.resize(numClusters);
+    for (uint32_t c = 0; c < numClusters; ++c) {
+        _clusters[c].begin = c * CLUSTER_SIZE;
+        _clusters[c].end = std::min(count, (c + 1) * CLUSTER_SIZE);
+    }
+    _clusterOffsets.resize(numClusters + 1);
+    _itemVisible.resize(count);
+    _visible.resize(count);
+    _visibleCount = 0;
+}
+
+void FrustumCuller::refitClusters() {
+    const uint32_t numClusters = static_cast<uint32_t>(_clusters.size());
+    ThreadPool::instance().parallelFor(numClusters, CLUSTER_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            Cluster& cluster = _clusters[c];
+
+            // Centro de la caja de los elementos, radio que los contiene a todos
+            const glm::vec4& first = _spheres[_order[cluster.begin]];
+            glm::vec3 lo = glm::vec3(first) - first.w;
+            glm::vec3 hi = glm::vec3(first) + first.w;
+            for (uint32_t k = cluster.begin + 1; k < cluster.end; ++k) {
+                const glm::vec4& sphere = _spheres[_order[k]];
+                lo = glm::min(lo, glm::vec3(sphere) - sphere.w);
+                hi = glm::max(hi, glm::vec3(sphere) + sphere.w);
+            }
+            const glm::vec3 center = (lo + hi) * 0.5f;
+
+            float radius = 0.0f;
+            for (uint32_t k = cluster.begin; k < cluster.end; ++k) {
+                const glm::vec4& sphere = _spheres[_order[k]];
+                radius = std::max(radius, glm::length(glm::vec3(sphere) - center) + sphere.w);
+            }
+            cluster.sphere = glm::vec4(center, radius);
+        }
+    });
+}
+
+uint32_t FrustumCuller::cull(const glm::mat4& viewProjection) {
+    const Frustum frustum = Frustum::fromMatrix(viewProjection);
+    const uint32_t numClusters = static_cast<uint32_t>(_clusters.size());
+    ThreadPool& pool = ThreadPool::instance();
+
+    // 1. Clasificar clusters y contar visibles de cada uno
+    pool.parallelFor(numClusters, CLUSTER_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            const Cluster& cluster = _clusters[c];
+            uint32_t visibleItems = 0;
+
+            switch (frustum.classify(cluster.sphere)) {
+                case Frustum::Result::Outside:
+                    break;
+                case Frustum::Result::Inside:
+                    visibleItems = cluster.end - cluster.begin;
+                    std::fill(_itemVisible.begin() + cluster.begin, _itemVisible.begin() + cluster.end, 1);
+                    break;
+                case Frustum::Result::Intersects:
+                    for (uint32_t k = cluster.begin; k < cluster.end; ++k) {
+                        bool inside = frustum.classify(_spheres[_order[k]]) != Frustum::Result::Outside;
+                        _itemVisible[k] = inside;
+                        visibleItems += inside;
+                    }
+                    break;
+            }
+            _clusterOffsets[c] = visibleItems;
+        }
+    });
+
+    // 2. Suma de prefijos (exclusiva) sobre los clusters
+    uint32_t total = 0;
+    for (uint32_t c = 0; c < numClusters; ++c) {
+        uint32_t visibleItems = _clusterOffsets[c];
+        _clusterOffsets[c] = total;
+        total += visibleItems;
+    }
+    if (numClusters > 0) _clusterOffsets[numClusters] = total;
+
+    // 3. Escribir los ids visibles en su posición final
+    pool.parallelFor(numClusters, CLUSTER_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            const Cluster& cluster = _clusters[c];
+            uint32_t out = _clusterOffsets[c];
+            if (out == _clusterOffsets[c + 1]) continue;
+            for (uint32_t k = cluster.begin; k < cluster.end; ++k) {
+                if (_itemVisible[k]) _visible[out++] = _order[k];
+            }
+        }
+    });
+
+    _visibleCount = total;
+    return total;
+}
+
+void FrustumCuller::clear() noexcept {
+    _spheres.clear();
+    _order.clear();
+    _clusters.clear();
+    _clusterOffsets.clear();
+    _itemVisible.clear();
+    _visible.clear();
+    _visibleCount = 0;
+    _ordered = false;
+}
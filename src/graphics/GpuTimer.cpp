@@ -0,0 +1,64 @@
+#include "graphics/GpuTimer.hpp"
+
+GpuTimer::~GpuTimer() {
+    destroy();
+}
+
+void GpuTimer::initialize() {
+    if (_initialized) return;
+    for (auto& set : _queries) {
+        glGenQueries(static_cast<GLsizei>(set.size()), set.data());
+    }
+    _initialized = true;
+}
+
+void GpuTimer::destroy() noexcept {
+    if (!_initialized) return;
+    if (_active < MAX_TIMERS) glEndQuery(GL_TIME_ELAPSED);
+    for (auto& set : _queries) {
+        glDeleteQueries(static_cast<GLsizei>(set.size()), set.data());
+        set.fill(0);
+    }
+    for (auto& issued : _issued) issued.fill(false);
+    _milliseconds.fill(0.0);
+    _active = MAX_TIMERS;
+    _initialized = false;
+}
+
+void GpuTimer::begin(uint32_t timer) noexcept {
+    if (!_initialized || timer >= MAX_TIMERS || _active < MAX_TIMERS) return;
+    glBeginQuery(GL_TIME_ELAPSED, _queries[_set][timer]);
+    _issued[_set][timer] = true;
+    _active = timer;
+}
+
+void GpuTimer::end() noexcept {
+    if (_active >= MAX_TIMERS) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    _active = MAX_TIMERS;
+}
+
+void GpuTimer::endFrame() noexcept {
+    if (!_initialized) return;
+    end();
+
+    // El juego del frame anterior: solo lo que ya está disponible
+    const uint32_t previous = _set ^ 1u;
+    for (uint32_t timer = 0; timer < MAX_TIMERS; ++timer) {
+        // Sin medida en ese frame (p. ej. nada que dibujar)
+        if (!_issued[previous][timer]) {
+            _milliseconds[timer] = 0.0;
+            continue;
+        }
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(_queries[previous][timer], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(_queries[previous][timer], GL_QUERY_RESULT, &nanoseconds);
+        _milliseconds[timer] = static_cast<double>(nanoseconds) * 1e-6;
+        _issued[previous][timer] = false;
+    }
+    _set = previous;
+}
@@ -0,0 +1,64 @@
+#include "graphics/LodBinner.hpp"
+#include "utils/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t BIN_BLOCK = 16384;       // Elementos por bloque del pool
+}
+
+uint8_t* LodBinner::levels(uint32_t count) {
+    _levels.resize(count);
+    return _levels.data();
+}
+
+void LodBinner::bin(const uint32_t* ids) {
+    const uint32_t count = size();
+    const uint32_t numBlocks = (count + BIN_BLOCK - 1) / BIN_BLOCK;
+    _blockOffsets.assign(static_cast<size_t>(numBlocks) * MAX_LEVELS, 0);
+    _ids.resize(count);
+    ThreadPool& pool = ThreadPool::instance();
+
+    // 1. Recuento por bloque y nivel
+    pool.parallelFor(numBlocks, 1, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; ++b) {
+            uint32_t* counts = &_blockOffsets[static_cast<size_t>(b) * MAX_LEVELS];
+            const uint32_t last = std::min(count, (b + 1) * BIN_BLOCK);
+            for (uint32_t i = b * BIN_BLOCK; i < last; ++i) {
+                ++counts[_levels[i]];
+            }
+        }
+    });
+
+    // 2. Suma de prefijos: nivel por nivel, bloque por bloque dentro de cada nivel
+    uint32_t total = 0;
+    for (uint32_t level = 0; level < MAX_LEVELS; ++level) {
+        _first[level] = total;
+        for (uint32_t b = 0; b < numBlocks; ++b) {
+            uint32_t& offset = _blockOffsets[static_cast<size_t>(b) * MAX_LEVELS + level];
+            uint32_t blockCount = offset;
+            offset = total;
+            total += blockCount;
+        }
+    }
+    _first[MAX_LEVELS] = total;
+
+    // 3. Escribir cada id en el rango de su nivel
+    pool.parallelFor(numBlocks, 1, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; ++b) {
+            uint32_t out[MAX_LEVELS];
+            std::copy_n(&_blockOffsets[static_cast<size_t>(b) * MAX_LEVELS], MAX_LEVELS, out);
+            const uint32_t last = std::min(count, (b + 1) * BIN_BLOCK);
+            for (uint32_t i = b * BIN_BLOCK; i < last; ++i) {
+                _ids[out[_levels[i]]++] = ids ? ids[i] : i;
+            }
+        }
+    });
+}
+
+void LodBinner::clear() noexcept {
+    _levels.clear();
+    _blockOffsets.clear();
+    _ids.clear();
+    _first.fill(0);
+}
@@ -0,0 +1,207 @@
+#include "graphics/RenderThread.hpp"
+#include "graphics/StreamBuffer.hpp"
+#include "core/Arcane.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/Trace.hpp"
+#include <iostream>
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start(GLFWwindow* window, GUI& gui) {
+    _window = window;
+    _stop.store(false, std::memory_order_relaxed);
+    _ready = std::promise<bool>();
+    std::future<bool> ready = _ready.get_future();
+
+    // Un contexto solo puede estar actual en un hilo
+    glfwMakeContextCurrent(nullptr);
+    _thread = std::thread(&RenderThread::run, this, std::ref(gui));
+    if (ready.get()) return true;
+
+    _thread.join();
+    glfwMakeContextCurrent(window);
+    return false;
+}
+
+void RenderThread::stop() {
+    if (!_thread.joinable()) return;
+    _stop.store(true, std::memory_order_release);
+    _thread.join();
+}
+
+void RenderThread::waitForPresent() noexcept {
+    _presented.wait(_waited, std::memory_order_acquire);
+    _waited = _presented.load(std::memory_order_acquire);
+}
+
+const RenderStats& RenderThread::stats() noexcept {
+    _stats.update();
+    return _stats.front();
+}
+
+void RenderThread::run(GUI& gui) {
+    glfwMakeContextCurrent(_window);
+    glfwSwapInterval(1); // VSync
+    if constexpr (Trace::COMPILED) {
+        Trace::setThreadName("Render");
+    }
+
+    _renderer = std::make_unique<Renderer>();
+    if (!_renderer->initialize(_window)) {
+        _renderer.reset();
+        glfwMakeContextCurrent(nullptr);
+        _ready.set_value(false);
+        return;
+    }
+    gui.initializeRenderer();
+
+    Profiler& profiler = Profiler::instance();
+    _framePhase = profiler.phase("Frame");
+    _ready.set_value(true);
+
+    while (!_stop.load(std::memory_order_acquire)) {
+        {
+            MULTIVERSO_TRACE_SCOPE("render", "Frame");
+            Profiler::Scope scope(_framePhase);
+
+            // El último snapshot publicado; si no hay uno nuevo se repite el anterior
+            _snapshots.update();
+            FrameSnapshot& frame = _snapshots.front();
+
+            if (frame.width != _width || frame.height != _height) {
+                _width = frame.width;
+                _height = frame.height;
+                glViewport(0, 0, _width, _height);
+            }
+
+            if (frame.arcane) {
+                apply(frame);
+                _renderer->setViewMatrix(frame.view);
+                _renderer->setProjectionMatrix(frame.projection);
+                _renderer->render(*frame.arcane);
+            } else {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            }
+            gui.renderDrawData(frame.ui);
+
+            RenderStats& stats = _stats.back();
+            stats.frame = frame.frame;
+            stats.uploadedBytes = _renderer->getUploadedBytes();
+            stats.culling = _renderer->isCulling();
+            stats.cull = _renderer->getCullStats();
+            stats.levelOfDetail = _renderer->isLevelOfDetail();
+            stats.draw = _renderer->getDrawStats();
+            _stats.publish();
+
+            MULTIVERSO_TRACE_SCOPE("render", "Swap");
+            glfwSwapBuffers(_window);
+        }
+        profiler.endFrame();
+
+        _presented.fetch_add(1, std::memory_order_release);
+        _presented.notify_all();
+    }
+
+    // Recursos GL con el contexto todavía actual
+    gui.cleanupRenderer();
+    _renderer->cleanup();
+    _renderer.reset();
+    _arcane.reset();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::apply(FrameSnapshot& frame) {
+    Arcane& arcane = *frame.arcane;
+
+    // Red nueva: llega con sus colores de origen y los estados se reaplican
+    const bool regenerated = frame.arcane != _arcane;
+    if (regenerated) {
+        _arcane = frame.arcane;
+        _pathVersion = 0;
+        _metricVersion = 0;
+        _focusVersion = 0;
+        _layoutVersion = 0;
+        _renderer->clearFocus();
+    }
+
+    // ----- Ajustes -----
+    const RenderSettings& requested = frame.settings;
+    if (requested.arrowMode != _settings.arrowMode) {
+        _renderer->setArrowMode(requested.arrowMode);
+        std::cout << "Flechas: " << (requested.arrowMode == ArrowRenderMode::Endpoints
+                                     ? "extremos (24 bytes, matriz en GPU)"
+                                     : "matrices (64 bytes, calculadas en CPU)") << std::endl;
+    }
+    if (regenerated || requested.arrowMode != _settings.arrowMode) {
+        arcane.setArrowTransformsEnabled(requested.arrowMode == ArrowRenderMode::Matrices);
+    }
+    if (requested.streaming != _settings.streaming) {
+        _renderer->setStreaming(requested.streaming);
+        if (_renderer->isStreaming()) {
+            std::cout << "Streaming de instancias: "
+                      << (StreamBuffer::persistentSupported() ? "mapeo persistente (ARB_buffer_storage)"
+                                                              : "glMapBufferRange por frame") << std::endl;
+        }
+    }
+    if (requested.culling != _settings.culling) {
+        _renderer->setCulling(requested.culling);
+    }
+    if (requested.levelOfDetail != _settings.levelOfDetail) {
+        _renderer->setLevelOfDetail(requested.levelOfDetail);
+    }
+    if (requested.gpuCulling != _settings.gpuCulling) {
+        _renderer->setGpuCulling(requested.gpuCulling);
+        if (requested.gpuCulling) {
+            std::cout << "Culling en GPU: " << (_renderer->isGpuCulling() ? "compute shader + multi draw indirect"
+                                                                          : "no disponible (requiere GL 4.3)") << std::endl;
+        }
+    }
+    if (requested.paletteColors != _settings.paletteColors) {
+        _renderer->setPaletteColors(requested.paletteColors);
+        std::cout << "Colores: " << (requested.paletteColors ? "paleta por nivel (4 bytes por instancia)"
+                                                             : "vec3 por instancia (12 bytes)") << std::endl;
+    }
+    if (requested.edgeBundling != _settings.edgeBundling) {
+        _renderer->setEdgeBundling(requested.edgeBundling);
+        if (requested.edgeBundling) {
+            std::cout << "Haces de flechas: celdas de " << EdgeBundler::STACKS << "x" << EdgeBundler::SECTORS
+                      << " por nivel" << (_renderer->isGpuCulling() ? " (compactación en CPU)" : "") << std::endl;
+        }
+    }
+    if (requested.sphereMode != _settings.sphereMode) {
+        // El renderer puede quedarse en malla si el impostor no compiló
+        _renderer->setSphereMode(requested.sphereMode);
+        std::cout << "Esferas: " << (_renderer->getSphereMode() == SphereRenderMode::Impostor ? "impostores" : "malla")
+                  << " (" << _renderer->getSphereTriangles() << " triángulos por nodo)" << std::endl;
+    }
+    _settings = requested;
+
+    // ----- Layout de fuerzas: solo se recalculan las flechas de los nodos movidos -----
+    if (frame.layoutVersion != _layoutVersion) {
+        _layoutVersion = frame.layoutVersion;
+        if (frame.layout && frame.layout->size() == arcane.getNumNodes()) {
+            arcane.moveNodes(frame.layout->data());
+        }
+    }
+
+    // ----- Estados de resaltado (la métrica antes: recolorea las flechas y conserva la ruta) -----
+    if (frame.metricVersion != _metricVersion) {
+        _metricVersion = frame.metricVersion;
+        if (frame.metric) arcane.applyNodeMetric(*frame.metric);
+        else arcane.resetNodeColors();
+    }
+    if (frame.pathVersion != _pathVersion) {
+        _pathVersion = frame.pathVersion;
+        auto dirty = frame.path ? arcane.highlightPath(*frame.path) : arcane.clearHighlight();
+        if (!dirty.empty()) {
+            std::cout << "Flechas recoloreadas: [" << dirty.begin << ", " << dirty.end << ")" << std::endl;
+        }
+    }
+    if (frame.focusVersion != _focusVersion) {
+        _focusVersion = frame.focusVersion;
+        if (frame.focus) _renderer->setFocus(arcane, *frame.focus);
+        else _renderer->clearFocus();
+    }
+}
@@ -1,9 +1,129 @@
 #include "graphics/Renderer.hpp"
 #include "graphics/ShaderManager.hpp"
+#include "graphics/ShaderCache.hpp"
 #include "graphics/Geometry.hpp"
+#include "graphics/StreamBuffer.hpp"
+#include "utils/ThreadPool.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/Trace.hpp"
 #include "core/Arcane.hpp"
-#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <iostream>
+#include <string>
+
+namespace {
+    // Radio de la esfera envolvente de las flechas para el culling (ver Geometry)
+    constexpr float ARROW_RADIUS = 0.05f;
+    
+    // Mallas de los niveles de detalle, generadas al compilar
+    constexpr auto SPHERE_HIGH = Geometry::Sphere<16, 32>::generate(Renderer::NODE_RADIUS);
+    constexpr auto SPHERE_MEDIUM = Geometry::Sphere<8, 16>::generate(Renderer::NODE_RADIUS);
+    constexpr auto SPHERE_LOW = Geometry::Sphere<4, 8>::generate(Renderer::NODE_RADIUS);
+    constexpr auto ARROW_HIGH = Geometry::Arrow<16>::generate(0.8f, 0.02f, 0.2f, ARROW_RADIUS);
+    constexpr auto ARROW_MEDIUM = Geometry::Arrow<8>::generate(0.8f, 0.02f, 0.2f, ARROW_RADIUS);
+    constexpr auto ARROW_LOW = Geometry::Arrow<4>::generate(0.8f, 0.02f, 0.2f, ARROW_RADIUS);
+    constexpr auto ARROW_LINE = Geometry::ArrowLine::generate();
+    constexpr uint32_t SPHERE_GRAIN = 16384;
+    
+    // Niveles de detalle: radio proyectado mínimo (píxeles) de cada nivel.
+    // Esferas: 16x32, 8x16 y 4x8. Flechas (radio de la punta): 16, 8 y 4
+    // segmentos; por debajo del último umbral, una línea.
+    constexpr float SPHERE_LOD_PIXELS[] = {12.0f, 4.0f};
+    constexpr float ARROW_LOD_PIXELS[] = {3.0f, 1.5f, 0.5f};
+    constexpr uint32_t LOD_GRAIN = 16384;
+    
+    uint8_t lodLevel(float pixels, const float* thresholds, uint32_t count) noexcept {
+        uint8_t level = 0;
+        while (level < count && pixels < thresholds[level]) ++level;
+        return level;
+    }
+    
+    // Punteros de los atributos de instancia que pueden venir de un buffer
+    // estático o de una región de StreamBuffer (offset en bytes). El VAO debe
+    // estar enlazado.
+    void pointSpherePositions(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)offset);
+    }
+    
+    void pointArrowMatrices(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (int i = 0; i < 4; ++i) {
+            glVertexAttribPointer(4 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(offset + i * sizeof(glm::vec4)));
+        }
+    }
+    
+    void pointArrowEndpoints(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribPointer(8, 3, GL_FLOAT, GL_FALSE, sizeof(ArrowEndpoints),
+                              (void*)(offset + offsetof(ArrowEndpoints, origen)));
+        glVertexAttribPointer(9, 3, GL_FLOAT, GL_FALSE, sizeof(ArrowEndpoints),
+                              (void*)(offset + offsetof(ArrowEndpoints, destino)));
+    }
+    
+    void pointColors(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)offset);
+    }
+    
+    void pointStyles(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribIPointer(11, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)offset);
+    }
+    
+    void pointFocusMask(GLuint buffer, GLintptr offset) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glVertexAttribPointer(1, 1, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(uint8_t), (void*)offset);
+    }
+    
+    // Tamaño redondeado a 4 bytes: los shaders de GL 4.3 leen la máscara como uint[]
+    void uploadFocusMask(GLuint buffer, const std::vector<uint8_t>& mask) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>((mask.size() + 3) & ~size_t(3)), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(mask.size()), mask.data());
+    }
+    
+    // ----- Culling en GPU -----
+    
+    // Layouts fijados por GL para glMultiDrawElementsIndirect / glDrawArraysIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+    
+    struct DrawArraysIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+    
+    // Contenido del buffer de comandos de una malla; el compute shader lo ve como uint[]
+    struct IndirectCommands {
+        std::array<DrawElementsIndirectCommand, LodBinner::MAX_LEVELS> elements;
+        DrawArraysIndirectCommand arrays;           // Impostores: 4 vértices por instancia
+    };
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20 && sizeof(DrawArraysIndirectCommand) == 16,
+                  "Los comandos indirectos deben tener el layout de GL");
+    constexpr GLint ARRAYS_COMMAND_WORD = offsetof(IndirectCommands, arrays) / sizeof(GLuint);
+    
+    constexpr uint32_t CULL_GROUP_SIZE = 64;           // local_size_x del compute shader
+    constexpr uint32_t MAX_CULL_GROUPS = 65535;        // Mínimo garantizado por eje de glDispatchCompute
+    
+    // SSBO que leen los vertex shaders de GL 4.3 (ver INSTANCE_STORAGE); los
+    // colores van en el binding 1 y los estilos del modo paleta en el 5
+    void bindInstanceStorage(GLuint geometry, GLuint colors, bool palette, GLuint focus) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, geometry);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, palette ? 5 : 1, colors);
+        if (focus) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, focus);
+    }
+}
 
 Renderer::Renderer() = default;
 
@@ -16,26 +136,121 @@ bool Renderer::initialize(GLFWwindow* window) {
     
     shaderManager = std::make_unique<ShaderManager>();
     
-    // Cargar shaders para flechas
-    auto arrowResult = shaderManager->loadShaderProgram("arrow", 
-                                                       ARROW_VERTEX_SHADER, 
-                                                       ARROW_FRAGMENT_SHADER);
+    // Cuerpos compartidos por las dos cabeceras de instancia
+    auto withAttributes = [](const char* body) { return std::string(INSTANCE_ATTRIBUTES) + PALETTE_COLORS + body; };
+    auto withStorage = [](const char* body) { return std::string(INSTANCE_STORAGE) + PALETTE_COLORS + body; };
+    const std::string arrowVertex = withAttributes(ARROW_VERTEX_BODY);
+    const std::string arrowEndpointsVertex = withAttributes(ARROW_ENDPOINTS_VERTEX_BODY);
+    const std::string sphereVertex = withAttributes(SPHERE_VERTEX_BODY);
+    const std::string impostorVertex = withAttributes(SPHERE_IMPOSTOR_VERTEX_BODY);
+    const std::string arrowIndirectVertex = withStorage(ARROW_ENDPOINTS_VERTEX_BODY);
+    const std::string sphereIndirectVertex = withStorage(SPHERE_VERTEX_BODY);
+    const std::string impostorIndirectVertex = withStorage(SPHERE_IMPOSTOR_VERTEX_BODY);
+    
+    // Compilar (o restaurar de la caché de binarios) todos los programas de una vez
+    const auto loadStart = std::chrono::steady_clock::now();
+    std::vector<ShaderManager::ProgramSource> sources = {
+        {"arrow", arrowVertex, ARROW_FRAGMENT_SHADER},
+        {"arrow_endpoints", arrowEndpointsVertex, ARROW_FRAGMENT_SHADER},     // Matriz a partir de los extremos
+        {"sphere", sphereVertex, SPHERE_FRAGMENT_SHADER},
+        {"sphere_impostor", impostorVertex, SPHERE_IMPOSTOR_FRAGMENT_SHADER}
+    };
+    
+    // Culling en GPU: compute shader, SSBO y multi draw indirect son núcleo desde GL 4.3
+    const bool indirect = GLAD_GL_VERSION_4_3;
+    if (indirect) {
+        sources.push_back({"arrow_indirect", arrowIndirectVertex, ARROW_FRAGMENT_SHADER});
+        sources.push_back({"sphere_indirect", sphereIndirectVertex, SPHERE_FRAGMENT_SHADER});
+        sources.push_back({"sphere_impostor_indirect", impostorIndirectVertex, SPHERE_IMPOSTOR_FRAGMENT_SHADER});
+        sources.push_back({"cull", {}, {}, CULL_COMPUTE_SHADER});
+    }
+    auto results = shaderManager->loadShaderPrograms(sources);
+    const auto& arrowResult = results[0];
+    const auto& arrowEndpointsResult = results[1];
+    const auto& sphereResult = results[2];
+    const auto& impostorResult = results[3];
+    
     if (!arrowResult.success) {
         std::cerr << "Failed to load arrow shader: " << arrowResult.errorMessage << std::endl;
         return false;
     }
-    
-    // Cargar shaders para esferas
-    auto sphereResult = shaderManager->loadShaderProgram("sphere", 
-                                                        SPHERE_VERTEX_SHADER, 
-                                                        SPHERE_FRAGMENT_SHADER);
+    if (!arrowEndpointsResult.success) {
+        std::cerr << "Failed to load arrow endpoints shader: " << arrowEndpointsResult.errorMessage << std::endl;
+        return false;
+    }
     if (!sphereResult.success) {
         std::cerr << "Failed to load sphere shader: " << sphereResult.errorMessage << std::endl;
         return false;
     }
+    if (!impostorResult.success) {
+        // La malla sigue disponible
+        std::cerr << "Failed to load sphere impostor shader: " << impostorResult.errorMessage << std::endl;
+        sphereMode = SphereRenderMode::Mesh;
+    }
+    
+    if (const ShaderCache* cache = shaderManager->cache()) {
+        std::cout << "Shaders: " << cache->hits() << " desde caché, " << cache->misses() << " compilados ("
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count()
+                  << " ms" << (cache->enabled() ? "" : ", caché de binarios no disponible") << ")" << std::endl;
+    }
+    
+    // Handles de programas y uniforms: el frame no busca nombres
+    arrowProgram = resolveProgram(arrowResult.handle);
+    arrowEndpointsProgram = resolveProgram(arrowEndpointsResult.handle);
+    sphereProgram = resolveProgram(sphereResult.handle);
+    impostorProgram = resolveProgram(impostorResult.handle);
     
     setupSphereBuffers();
     setupArrowBuffers();
+    bundleBuffers.setup(arrowBuffers);
+    
+    // Sin alguno de los programas de GL 4.3 se queda el culling en CPU
+    if (indirect) {
+        const bool loaded = std::all_of(results.begin() + 4, results.end(),
+                                        [](const ShaderManager::ShaderResult& result) { return result.success; });
+        if (loaded) {
+            arrowIndirectProgram = resolveProgram(results[4].handle);
+            sphereIndirectProgram = resolveProgram(results[5].handle);
+            impostorIndirectProgram = resolveProgram(results[6].handle);
+            
+            const ShaderManager::ProgramHandle cull = results[7].handle;
+            cullProgram.program = cull;
+            cullProgram.viewProjection = shaderManager->findUniform(cull, "viewProjection");
+            cullProgram.depthAxis = shaderManager->findUniform(cull, "depthAxis");
+            cullProgram.depthOffset = shaderManager->findUniform(cull, "depthOffset");
+            cullProgram.focal = shaderManager->findUniform(cull, "focal");
+            cullProgram.radius = shaderManager->findUniform(cull, "radius");
+            cullProgram.thresholds = shaderManager->findUniform(cull, "thresholds");
+            cullProgram.levels = shaderManager->findUniform(cull, "levels");
+            cullProgram.count = shaderManager->findUniform(cull, "count");
+            cullProgram.capacity = shaderManager->findUniform(cull, "capacity");
+            cullProgram.commandBase = shaderManager->findUniform(cull, "commandBase");
+            cullProgram.arrows = shaderManager->findUniform(cull, "arrows");
+            cullProgram.culling = shaderManager->findUniform(cull, "culling");
+            
+            sphereIndirect.setup(sphereBuffers);
+            arrowIndirect.setup(arrowBuffers);
+        } else {
+            for (size_t i = 4; i < results.size(); ++i) {
+                if (!results[i].success) {
+                    std::cerr << "Failed to load " << sources[i].name << " shader: " << results[i].errorMessage << std::endl;
+                }
+            }
+        }
+    }
+    
+    Profiler& profiler = Profiler::instance();
+    phases.instances = profiler.phase("Instancias");
+    phases.arrows = profiler.phase("Flechas");
+    phases.spheres = profiler.phase("Esferas");
+    phases.gpuArrows = profiler.phase("Flechas (GPU)");
+    phases.gpuSpheres = profiler.phase("Esferas (GPU)");
+    phases.gpuCulling = profiler.phase("Culling (GPU)");
+    gpuTimer.initialize();
+    
+    // Valores constantes de los atributos de foco y estilo cuando su array está desactivado
+    glVertexAttrib1f(1, 1.0f);
+    glVertexAttribI4ui(11, 0, 0, 0, 0);
     
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_MULTISAMPLE);
@@ -44,43 +259,61 @@ bool Renderer::initialize(GLFWwindow* window) {
     return true;
 }
 
+Renderer::ProgramUniforms Renderer::resolveProgram(ShaderManager::ProgramHandle program) const {
+    ProgramUniforms uniforms;
+    uniforms.program = program;
+    uniforms.view = shaderManager->findUniform(program, "view");
+    uniforms.projection = shaderManager->findUniform(program, "projection");
+    uniforms.mvp = shaderManager->findUniform(program, "mvp");
+    uniforms.sphereRadius = shaderManager->findUniform(program, "sphereRadius");
+    uniforms.thickness = shaderManager->findUniform(program, "thickness");
+    uniforms.radius = shaderManager->findUniform(program, "radius");
+    uniforms.focusActive = shaderManager->findUniform(program, "focusActive");
+    uniforms.paletteColors = shaderManager->findUniform(program, "paletteColors");
+    uniforms.palette = shaderManager->findUniform(program, "palette");
+    uniforms.paletteScale = shaderManager->findUniform(program, "paletteScale");
+    uniforms.highlightColor = shaderManager->findUniform(program, "highlightColor");
+    return uniforms;
+}
+
 void Renderer::setupSphereBuffers() {
     glGenVertexArrays(1, &sphereBuffers.VAO);
     glGenBuffers(1, &sphereBuffers.VBO);
     glGenBuffers(1, &sphereBuffers.EBO);
-    glGenBuffers(2, sphereBuffers.instanceVBOs.data());
-    
-    auto sphereVertices = Geometry::generateSphereVertices();
-    auto sphereIndices = Geometry::generateSphereIndices();
+    glGenBuffers(static_cast<GLsizei>(sphereBuffers.instanceVBOs.size()), sphereBuffers.instanceVBOs.data());
     
     glBindVertexArray(sphereBuffers.VAO);
     
-    // Vértices
-    glBindBuffer(GL_ARRAY_BUFFER, sphereBuffers.VBO);
-    glBufferData(GL_ARRAY_BUFFER, sphereVertices.size() * sizeof(float), 
-                 sphereVertices.data(), GL_STATIC_DRAW);
-    
-    // Índices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereBuffers.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sphereIndices.size() * sizeof(unsigned int),
-                 sphereIndices.data(), GL_STATIC_DRAW);
+    // Vértices e índices de los tres niveles (stacks x sectors)
+    static_assert(std::is_same_v<decltype(SPHERE_HIGH)::Index, MeshIndex>, "Las mallas deben usar índices de 16 bits");
+    sphereBuffers.uploadLods({
+        {SPHERE_HIGH.vertices, SPHERE_HIGH.indices},
+        {SPHERE_MEDIUM.vertices, SPHERE_MEDIUM.indices},
+        {SPHERE_LOW.vertices, SPHERE_LOW.indices}
+    });
     
     // Atributos de vértice (posición)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     
     // Buffers de instancia para posiciones
-    glBindBuffer(GL_ARRAY_BUFFER, sphereBuffers.instanceVBOs[0]);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    pointSpherePositions(sphereBuffers.instanceVBOs[0], 0);
     glEnableVertexAttribArray(2);
     glVertexAttribDivisor(2, 1);
     
     // Buffers de instancia para colores
-    glBindBuffer(GL_ARRAY_BUFFER, sphereBuffers.instanceVBOs[1]);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    pointColors(sphereBuffers.instanceVBOs[1], 0);
     glEnableVertexAttribArray(3);
     glVertexAttribDivisor(3, 1);
     
+    // Estilos del modo paleta (desactivados hasta setPaletteColors)
+    pointStyles(sphereBuffers.instanceVBOs[4], 0);
+    glVertexAttribDivisor(11, 1);
+    
+    // Máscara de foco (desactivada hasta setFocus)
+    pointFocusMask(sphereBuffers.instanceVBOs[2], 0);
+    glVertexAttribDivisor(1, 1);
+    
     glBindVertexArray(0);
 }
 
@@ -88,131 +321,1002 @@ void Renderer::setupArrowBuffers() {
     glGenVertexArrays(1, &arrowBuffers.VAO);
     glGenBuffers(1, &arrowBuffers.VBO);
     glGenBuffers(1, &arrowBuffers.EBO);
-    glGenBuffers(2, arrowBuffers.instanceVBOs.data());
-    
-    auto arrowVertices = Geometry::generateArrowVertices();
-    auto arrowIndices = Geometry::generateArrowIndices();
+    glGenBuffers(static_cast<GLsizei>(arrowBuffers.instanceVBOs.size()), arrowBuffers.instanceVBOs.data());
     
     glBindVertexArray(arrowBuffers.VAO);
     
-    // Vértices
-    glBindBuffer(GL_ARRAY_BUFFER, arrowBuffers.VBO);
-    glBufferData(GL_ARRAY_BUFFER, arrowVertices.size() * sizeof(float),
-                 arrowVertices.data(), GL_STATIC_DRAW);
-    
-    // Índices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arrowBuffers.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, arrowIndices.size() * sizeof(unsigned int),
-                 arrowIndices.data(), GL_STATIC_DRAW);
+    // Vértices e índices de los niveles: 16, 8 y 4 segmentos y una línea
+    static_assert(std::is_same_v<decltype(ARROW_HIGH)::Index, MeshIndex>, "Las mallas deben usar índices de 16 bits");
+    arrowBuffers.uploadLods({
+        {ARROW_HIGH.vertices, ARROW_HIGH.indices},
+        {ARROW_MEDIUM.vertices, ARROW_MEDIUM.indices},
+        {ARROW_LOW.vertices, ARROW_LOW.indices},
+        {ARROW_LINE.vertices, ARROW_LINE.indices, GL_LINES}
+    });
     
     // Atributos de vértice (posición)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     
     // Matrices de instancia (location 4-7)
-    glBindBuffer(GL_ARRAY_BUFFER, arrowBuffers.instanceVBOs[0]);
-    size_t vec4Size = sizeof(glm::vec4);
+    pointArrowMatrices(arrowBuffers.instanceVBOs[0], 0);
     for (int i = 0; i < 4; ++i) {
         glEnableVertexAttribArray(4 + i);
-        glVertexAttribPointer(4 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
-                             (void*)(i * vec4Size));
         glVertexAttribDivisor(4 + i, 1);
     }
     
     // Colores de instancia
-    glBindBuffer(GL_ARRAY_BUFFER, arrowBuffers.instanceVBOs[1]);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    pointColors(arrowBuffers.instanceVBOs[1], 0);
     glEnableVertexAttribArray(3);
     glVertexAttribDivisor(3, 1);
     
+    // Estilos del modo paleta (desactivados hasta setPaletteColors)
+    pointStyles(arrowBuffers.instanceVBOs[4], 0);
+    glVertexAttribDivisor(11, 1);
+    
+    // Máscara de foco (desactivada hasta setFocus)
+    pointFocusMask(arrowBuffers.instanceVBOs[2], 0);
+    glVertexAttribDivisor(1, 1);
+    
+    // Extremos de instancia (location 8-9, activos solo en modo Endpoints)
+    pointArrowEndpoints(arrowBuffers.instanceVBOs[3], 0);
+    glVertexAttribDivisor(8, 1);
+    glVertexAttribDivisor(9, 1);
+    
     glBindVertexArray(0);
 }
 
-void Renderer::updateSphereInstances(const Arcane& arcane) {
-    auto positions = arcane.getNodePositions();
-    auto colors = arcane.getNodeColors();
+void Renderer::setArrowMode(ArrowRenderMode mode) {
+    if (mode == arrowMode) return;
+    arrowMode = mode;
     
-    if (!positions.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, sphereBuffers.instanceVBOs[0]);
-        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3),
-                     positions.data(), GL_DYNAMIC_DRAW);
+    // Activar solo los atributos de instancia del modo elegido
+    const bool endpoints = (mode == ArrowRenderMode::Endpoints);
+    glBindVertexArray(arrowBuffers.VAO);
+    for (int i = 0; i < 4; ++i) {
+        if (endpoints) glDisableVertexAttribArray(4 + i);
+        else glEnableVertexAttribArray(4 + i);
+    }
+    for (int i = 8; i <= 9; ++i) {
+        if (endpoints) glEnableVertexAttribArray(i);
+        else glDisableVertexAttribArray(i);
     }
+    glBindVertexArray(0);
+}
+
+void Renderer::setSphereMode(SphereRenderMode mode) {
+    // Sin el shader de impostores se mantiene la malla
+    if (mode == SphereRenderMode::Impostor && !impostorProgram.program.valid()) {
+        mode = SphereRenderMode::Mesh;
+    }
+    sphereMode = mode;
+}
+
+void Renderer::setStreaming(bool enabled) {
+    if (enabled == streaming) return;
+    streaming = enabled;
     
-    if (!colors.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, sphereBuffers.instanceVBOs[1]);
-        glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec3),
-                     colors.data(), GL_DYNAMIC_DRAW);
+    if (!enabled) {
+        // Volver a los buffers estáticos con una subida completa
+        glBindVertexArray(sphereBuffers.VAO);
+        pointSpherePositions(sphereBuffers.instanceVBOs[0], 0);
+        glBindVertexArray(arrowBuffers.VAO);
+        pointArrowMatrices(arrowBuffers.instanceVBOs[0], 0);
+        pointArrowEndpoints(arrowBuffers.instanceVBOs[3], 0);
+        glBindVertexArray(0);
+        
+        sphereBuffers.uploads[0].version = 0;
+        arrowBuffers.uploads[0].version = 0;
+        arrowBuffers.uploads[3].version = 0;
+        
+        sphereStream.destroy();
+        arrowStream.destroy();
     }
 }
 
+void Renderer::setPaletteColors(bool enabled) {
+    if (enabled == paletteColors) return;
+    paletteColors = enabled;
+    
+    // Cada VAO lee el color (location 3) o el estilo (location 11)
+    for (GLuint vao : {sphereBuffers.VAO, arrowBuffers.VAO}) {
+        glBindVertexArray(vao);
+        if (enabled) {
+            glDisableVertexAttribArray(3);
+            glEnableVertexAttribArray(11);
+        } else {
+            glDisableVertexAttribArray(11);
+            glEnableVertexAttribArray(3);
+        }
+    }
+    glBindVertexArray(0);
+    compactValid = false;
+}
+
+void Renderer::streamSpherePositions(const Arcane& arcane) {
+    const uint32_t numNodes = arcane.getNumNodes();
+    if (numNodes == 0) return;
+    
+    sphereStream.reserve(static_cast<GLsizeiptr>(numNodes) * sizeof(glm::vec3));
+    void* dst = sphereStream.map();
+    if (dst) {
+        arcane.writeNodePositions(0, numNodes, static_cast<glm::vec3*>(dst));
+    }
+    GLintptr offset = sphereStream.unmap();
+    
+    glBindVertexArray(sphereBuffers.VAO);
+    pointSpherePositions(sphereStream.id(), offset);
+    glBindVertexArray(0);
+    uploadedBytes += static_cast<uint64_t>(numNodes) * sizeof(glm::vec3);
+}
+
+void Renderer::streamArrowGeometry(const Arcane& arcane) {
+    const uint32_t numArrows = arcane.getNumArrows();
+    if (numArrows == 0) return;
+    
+    const bool endpoints = (arrowMode == ArrowRenderMode::Endpoints);
+    const size_t stride = endpoints ? sizeof(ArrowEndpoints) : sizeof(glm::mat4);
+    arrowStream.reserve(static_cast<GLsizeiptr>(numArrows) * stride);
+    
+    void* dst = arrowStream.map();
+    if (!dst) {
+        arrowStream.unmap();
+        return;
+    }
+    if (endpoints) {
+        arcane.writeArrowEndpoints(0, numArrows, static_cast<ArrowEndpoints*>(dst));
+    } else {
+        arcane.writeArrowTransforms(0, numArrows, static_cast<glm::mat4*>(dst));
+    }
+    GLintptr offset = arrowStream.unmap();
+    
+    glBindVertexArray(arrowBuffers.VAO);
+    if (endpoints) pointArrowEndpoints(arrowStream.id(), offset);
+    else pointArrowMatrices(arrowStream.id(), offset);
+    glBindVertexArray(0);
+    uploadedBytes += static_cast<uint64_t>(numArrows) * stride;
+}
+
+template<typename T, typename Writer>
+void Renderer::uploadInstances(GLuint vbo, InstanceUpload& state, const InstanceVersion& source,
+                               uint32_t count, Writer&& write) {
+    if (count == 0) {
+        state.count = 0;
+        return;
+    }
+    
+    // Sin cambios desde la última subida
+    bool full = (state.count != count || state.version < source.base);
+    if (!full && state.version == source.version) return;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    
+    // Crecimiento geométrico: el almacenamiento solo se recrea al quedarse corto
+    if (count > state.capacity) {
+        state.capacity = std::max(count, state.capacity + state.capacity / 2);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(state.capacity) * sizeof(T),
+                     nullptr, GL_DYNAMIC_DRAW);
+        full = true;
+    }
+    
+    uint32_t first = 0, size = count;
+    if (!full) {
+        first = std::min(source.dirty.begin, count);
+        size = std::min(source.dirty.end, count) - first;
+    }
+    
+    if (size > 0) {
+        const size_t bytes = static_cast<size_t>(size) * sizeof(T);
+        if (uploadStaging.size() < bytes) uploadStaging.resize(bytes);
+        
+        T* staging = reinterpret_cast<T*>(uploadStaging.data());
+        write(first, size, staging);
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first) * sizeof(T),
+                        static_cast<GLsizeiptr>(bytes), staging);
+        uploadedBytes += bytes;
+    }
+    
+    state.version = source.version;
+    state.count = count;
+}
+
+void Renderer::updateSphereInstances(const Arcane& arcane) {
+    const uint32_t numNodes = arcane.getNumNodes();
+    
+    if (streaming) {
+        streamSpherePositions(arcane);
+    } else {
+        uploadInstances<glm::vec3>(sphereBuffers.instanceVBOs[0], sphereBuffers.uploads[0],
+                                   arcane.getInstanceVersion(InstanceData::NodePositions), numNodes,
+                                   [&](uint32_t first, uint32_t size, glm::vec3* dst) {
+                                       arcane.writeNodePositions(first, size, dst);
+                                   });
+    }
+    
+    uploadNodeColors(arcane, nullptr, numNodes);
+}
+
 void Renderer::updateArrowInstances(const Arcane& arcane) {
-    auto transforms = arcane.getArrowTransforms();
-    auto colors = arcane.getArrowColors();
+    const uint32_t numArrows = arcane.getNumArrows();
+    
+    uploadArrowColors(arcane, nullptr, numArrows);
     
-    if (!transforms.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, arrowBuffers.instanceVBOs[0]);
-        glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4),
-                     transforms.data(), GL_DYNAMIC_DRAW);
+    if (streaming) {
+        streamArrowGeometry(arcane);
+    } else if (arrowMode == ArrowRenderMode::Endpoints) {
+        uploadInstances<ArrowEndpoints>(arrowBuffers.instanceVBOs[3], arrowBuffers.uploads[3],
+                                        arcane.getInstanceVersion(InstanceData::ArrowEndpoints), numArrows,
+                                        [&](uint32_t first, uint32_t size, ArrowEndpoints* dst) {
+                                            arcane.writeArrowEndpoints(first, size, dst);
+                                        });
+    } else {
+        uploadInstances<glm::mat4>(arrowBuffers.instanceVBOs[0], arrowBuffers.uploads[0],
+                                   arcane.getInstanceVersion(InstanceData::ArrowTransforms), numArrows,
+                                   [&](uint32_t first, uint32_t size, glm::mat4* dst) {
+                                       arcane.writeArrowTransforms(first, size, dst);
+                                   });
     }
+}
+
+template<typename T, typename Writer>
+void Renderer::uploadCompacted(GLuint vbo, InstanceUpload& state, uint32_t count, Writer&& write) {
+    // El contenido ya no corresponde a ninguna versión de Arcane: al volver
+    // a la subida por versiones se sube completo
+    state.version = 0;
+    state.count = 0;
+    if (count == 0) return;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (count > state.capacity) {
+        state.capacity = std::max(count, state.capacity + state.capacity / 2);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(state.capacity) * sizeof(T),
+                     nullptr, GL_DYNAMIC_DRAW);
+    }
+    
+    const size_t bytes = static_cast<size_t>(count) * sizeof(T);
+    if (uploadStaging.size() < bytes) uploadStaging.resize(bytes);
     
-    if (!colors.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, arrowBuffers.instanceVBOs[1]);
-        glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec3),
-                     colors.data(), GL_DYNAMIC_DRAW);
+    T* staging = reinterpret_cast<T*>(uploadStaging.data());
+    write(staging);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(bytes), staging);
+    uploadedBytes += bytes;
+}
+
+void Renderer::uploadNodeColors(const Arcane& arcane, const uint32_t* ids, uint32_t count) {
+    if (paletteColors) {
+        if (ids) {
+            uploadCompacted<uint32_t>(sphereBuffers.instanceVBOs[4], sphereBuffers.uploads[4], count,
+                                      [&](uint32_t* dst) { arcane.gatherNodeStyles(ids, count, dst); });
+        } else {
+            uploadInstances<uint32_t>(sphereBuffers.instanceVBOs[4], sphereBuffers.uploads[4],
+                                      arcane.getInstanceVersion(InstanceData::NodeStyles), count,
+                                      [&](uint32_t first, uint32_t size, uint32_t* dst) {
+                                          arcane.writeNodeStyles(first, size, dst);
+                                      });
+        }
+    } else if (ids) {
+        uploadCompacted<glm::vec3>(sphereBuffers.instanceVBOs[1], sphereBuffers.uploads[1], count,
+                                   [&](glm::vec3* dst) { arcane.gatherNodeColors(ids, count, dst); });
+    } else {
+        uploadInstances<glm::vec3>(sphereBuffers.instanceVBOs[1], sphereBuffers.uploads[1],
+                                   arcane.getInstanceVersion(InstanceData::NodeColors), count,
+                                   [&](uint32_t first, uint32_t size, glm::vec3* dst) {
+                                       arcane.writeNodeColors(first, size, dst);
+                                   });
     }
 }
 
+void Renderer::uploadArrowColors(const Arcane& arcane, const uint32_t* ids, uint32_t count) {
+    if (paletteColors) {
+        if (ids) {
+            uploadCompacted<uint32_t>(arrowBuffers.instanceVBOs[4], arrowBuffers.uploads[4], count,
+                                      [&](uint32_t* dst) { arcane.gatherArrowStyles(ids, count, dst); });
+        } else {
+            uploadInstances<uint32_t>(arrowBuffers.instanceVBOs[4], arrowBuffers.uploads[4],
+                                      arcane.getInstanceVersion(InstanceData::ArrowStyles), count,
+                                      [&](uint32_t first, uint32_t size, uint32_t* dst) {
+                                          arcane.writeArrowStyles(first, size, dst);
+                                      });
+        }
+    } else if (ids) {
+        uploadCompacted<glm::vec3>(arrowBuffers.instanceVBOs[1], arrowBuffers.uploads[1], count,
+                                   [&](glm::vec3* dst) { arcane.gatherArrowColors(ids, count, dst); });
+    } else {
+        uploadInstances<glm::vec3>(arrowBuffers.instanceVBOs[1], arrowBuffers.uploads[1],
+                                   arcane.getInstanceVersion(InstanceData::ArrowColors), count,
+                                   [&](uint32_t first, uint32_t size, glm::vec3* dst) {
+                                       arcane.writeArrowColors(first, size, dst);
+                                   });
+    }
+}
+
+void Renderer::setColorUniforms(const ProgramUniforms& program, const Arcane& arcane, float scale) {
+    shaderManager->setUniform(program.paletteColors, paletteColors ? 1 : 0);
+    if (!paletteColors) return;
+    
+    // La paleta cabe en un uniform: recolorear no sube datos de instancia
+    const DynamicArray<glm::vec3>& palette = arcane.getPalette();
+    shaderManager->setUniform(program.palette, palette.data(), static_cast<uint32_t>(palette.size()));
+    shaderManager->setUniform(program.paletteScale, scale);
+    shaderManager->setUniform(program.highlightColor, arcane.getHighlightColor());
+}
+
+void Renderer::setCulling(bool enabled) {
+    if (enabled == culling) return;
+    const bool wasCompacting = compacting();
+    culling = enabled;
+    if (!enabled) {
+        nodeCuller.clear();
+        arrowCuller.clear();
+        cullStats = CullStats();
+    }
+    compactionChanged(wasCompacting);
+}
+
+void Renderer::setLevelOfDetail(bool enabled) {
+    if (enabled == levelOfDetail) return;
+    const bool wasCompacting = compacting();
+    levelOfDetail = enabled;
+    if (!enabled) {
+        nodeBinner.clear();
+        arrowBinner.clear();
+    }
+    compactionChanged(wasCompacting);
+}
+
+void Renderer::setGpuCulling(bool enabled) {
+    if (enabled && !supportsGpuCulling()) enabled = false;
+    if (enabled == gpuCulling) return;
+    gpuCulling = enabled;
+    
+    // Al volver a la CPU se compacta desde cero; las estadísticas de la GPU
+    // que aún no se leyeron ya no corresponden
+    compactValid = false;
+    if (gpuStatsFence) {
+        glDeleteSync(gpuStatsFence);
+        gpuStatsFence = nullptr;
+    }
+}
+
+void Renderer::setEdgeBundling(bool enabled) {
+    if (enabled == edgeBundling) return;
+    const bool wasCompacting = compacting();
+    edgeBundling = enabled;
+    if (!enabled) {
+        edgeBundler.clear();
+        drawStats.bundles = 0;
+        drawStats.bundledArrows = 0;
+    }
+    compactionChanged(wasCompacting);
+}
+
+void Renderer::compactionChanged(bool wasCompacting) {
+    compactValid = false;
+    if (compacting() == wasCompacting) return;
+    
+    if (compacting()) {
+        // Los datos compactados van a los buffers estáticos, no al anillo
+        if (streaming) {
+            glBindVertexArray(sphereBuffers.VAO);
+            pointSpherePositions(sphereBuffers.instanceVBOs[0], 0);
+            glBindVertexArray(arrowBuffers.VAO);
+            pointArrowMatrices(arrowBuffers.instanceVBOs[0], 0);
+            pointArrowEndpoints(arrowBuffers.instanceVBOs[3], 0);
+            glBindVertexArray(0);
+        }
+    } else {
+        // Las instancias se vuelven a subir completas por versiones
+        if (focusActive) uploadFocusMasks();
+    }
+}
+
+void Renderer::pointSphereInstances(uint32_t first) {
+    glBindVertexArray(sphereBuffers.VAO);
+    pointSpherePositions(sphereBuffers.instanceVBOs[0], static_cast<GLintptr>(first) * sizeof(glm::vec3));
+    pointColors(sphereBuffers.instanceVBOs[1], static_cast<GLintptr>(first) * sizeof(glm::vec3));
+    pointStyles(sphereBuffers.instanceVBOs[4], static_cast<GLintptr>(first) * sizeof(uint32_t));
+    pointFocusMask(sphereBuffers.instanceVBOs[2], static_cast<GLintptr>(first));
+}
+
+void Renderer::pointArrowInstances(uint32_t first) {
+    glBindVertexArray(arrowBuffers.VAO);
+    if (arrowMode == ArrowRenderMode::Endpoints) {
+        pointArrowEndpoints(arrowBuffers.instanceVBOs[3], static_cast<GLintptr>(first) * sizeof(ArrowEndpoints));
+    } else {
+        pointArrowMatrices(arrowBuffers.instanceVBOs[0], static_cast<GLintptr>(first) * sizeof(glm::mat4));
+    }
+    pointColors(arrowBuffers.instanceVBOs[1], static_cast<GLintptr>(first) * sizeof(glm::vec3));
+    pointStyles(arrowBuffers.instanceVBOs[4], static_cast<GLintptr>(first) * sizeof(uint32_t));
+    pointFocusMask(arrowBuffers.instanceVBOs[2], static_cast<GLintptr>(first));
+}
+
+void Renderer::compactInstances(const Arcane& arcane) {
+    const auto start = std::chrono::steady_clock::now();
+    const uint32_t numNodes = arcane.getNumNodes();
+    const uint32_t numArrows = arcane.getNumArrows();
+    const bool endpoints = (arrowMode == ArrowRenderMode::Endpoints);
+    const bool sphereLevels = levelOfDetail && sphereMode == SphereRenderMode::Mesh;
+    
+    // Distancia focal en píxeles: radio proyectado = radio * focal / profundidad
+    GLint viewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    CompactKey key;
+    key.viewProjection = projection * view;
+    key.focalPixels = levelOfDetail ? projection[1][1] * static_cast<float>(viewport[3]) * 0.5f : 0.0f;
+    key.network = arcane.getVersion();
+    key.nodePositions = arcane.getInstanceVersion(InstanceData::NodePositions).version;
+    key.nodeColors = arcane.getInstanceVersion(paletteColors ? InstanceData::NodeStyles
+                                                             : InstanceData::NodeColors).version;
+    key.arrowGeometry = arcane.getInstanceVersion(endpoints ? InstanceData::ArrowEndpoints
+                                                            : InstanceData::ArrowTransforms).version;
+    key.arrowColors = arcane.getInstanceVersion(paletteColors ? InstanceData::ArrowStyles
+                                                              : InstanceData::ArrowColors).version;
+    key.focus = focusActive ? focusGeneration : 0;
+    key.mode = arrowMode;
+    key.sphereMode = sphereMode;
+    key.culling = culling;
+    key.levelOfDetail = levelOfDetail;
+    key.palette = paletteColors;
+    key.bundling = edgeBundling;
+    
+    if (compactValid && key == lastCompact) return;     // Se conservan los recuentos y el tiempo anteriores
+    
+    // ----- Culling: ids visibles -----
+    uint32_t visibleNodes = numNodes;
+    uint32_t visibleArrows = numArrows;
+    const uint32_t* nodeIds = nullptr;          // nullptr = todos, en orden
+    const uint32_t* arrowIds = nullptr;
+    
+    if (culling) {
+        // Red nueva: los clusters se reordenan desde cero
+        if (!compactValid || key.network != lastCompact.network) {
+            nodeCuller.clear();
+            arrowCuller.clear();
+        }
+        
+        // Esferas envolventes, solo cuando se mueven los nodos
+        if (nodeCuller.size() != numNodes || arrowCuller.size() != numArrows ||
+            key.nodePositions != lastCompact.nodePositions) {
+            ThreadPool& pool = ThreadPool::instance();
+            
+            const Node* nodes = arcane.getNodes().data();
+            glm::vec4* nodeSpheres = nodeCuller.spheres(numNodes);
+            pool.parallelFor(numNodes, SPHERE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    nodeSpheres[i] = glm::vec4(nodes[i]._posicion, NODE_RADIUS);
+                }
+            });
+            nodeCuller.commit();
+            
+            // Flecha: esfera centrada en el punto medio que contiene el segmento
+            const Arrow* arrows = arcane.getArrows().data();
+            glm::vec4* arrowSpheres = arrowCuller.spheres(numArrows);
+            pool.parallelFor(numArrows, SPHERE_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    const glm::vec3& o = arrows[i]._origen->_posicion;
+                    const glm::vec3& d = arrows[i]._destino->_posicion;
+                    arrowSpheres[i] = glm::vec4((o + d) * 0.5f, glm::length(d - o) * 0.5f + ARROW_RADIUS);
+                }
+            });
+            arrowCuller.commit();
+        }
+        
+        visibleNodes = nodeCuller.cull(key.viewProjection);
+        visibleArrows = arrowCuller.cull(key.viewProjection);
+        nodeIds = nodeCuller.visible();
+        arrowIds = arrowCuller.visible();
+    }
+    
+    // ----- Haces: flechas sueltas cerca de la cámara, el resto agrupadas -----
+    drawStats.bundles = 0;
+    drawStats.bundledArrows = 0;
+    if (edgeBundling) {
+        const glm::vec3 eye(glm::inverse(view)[3]);
+        edgeBundler.update(arcane);
+        visibleArrows = edgeBundler.expand(eye, arrowIds, visibleArrows);
+        arrowIds = edgeBundler.expandedIds();
+        
+        drawStats.bundles = edgeBundler.collapsedCount();
+        drawStats.bundledArrows = edgeBundler.collapsedArrows();
+        uploadCompacted<glm::mat4>(bundleBuffers.instanceVBOs[0], bundleBuffers.uploads[0], drawStats.bundles,
+                                   [&](glm::mat4* dst) { edgeBundler.writeTransforms(dst); });
+        uploadCompacted<glm::vec3>(bundleBuffers.instanceVBOs[1], bundleBuffers.uploads[1], drawStats.bundles,
+                                   [&](glm::vec3* dst) { edgeBundler.writeColors(dst); });
+    }
+    
+    // ----- LOD: reparto por tamaño proyectado -----
+    drawStats.nodeLevels.fill(0);
+    drawStats.arrowLevels.fill(0);
+    drawStats.nodeLevels[0] = visibleNodes;
+    drawStats.arrowLevels[0] = visibleArrows;
+    
+    if (levelOfDetail) {
+        ThreadPool& pool = ThreadPool::instance();
+        
+        // Profundidad en espacio de vista: -(fila 2 de view) . p
+        const glm::vec3 depthAxis(-view[0][2], -view[1][2], -view[2][2]);
+        const float depthOffset = -view[3][2];
+        const float focal = key.focalPixels;
+        
+        if (sphereLevels) {
+            const Node* nodes = arcane.getNodes().data();
+            uint8_t* levels = nodeBinner.levels(visibleNodes);
+            pool.parallelFor(visibleNodes, LOD_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    const glm::vec3& p = nodes[nodeIds ? nodeIds[i] : i]._posicion;
+                    const float depth = std::max(glm::dot(depthAxis, p) + depthOffset, 1e-3f);
+                    levels[i] = lodLevel(NODE_RADIUS * focal / depth, SPHERE_LOD_PIXELS, 2);
+                }
+            });
+            nodeBinner.bin(nodeIds);
+            nodeIds = nodeBinner.ids();
+            for (uint32_t level = 0; level < LodBinner::MAX_LEVELS; ++level) {
+                drawStats.nodeLevels[level] = nodeBinner.count(level);
+            }
+        }
+        
+        // Flechas: radio de la punta a la profundidad del extremo más cercano
+        const Arrow* arrows = arcane.getArrows().data();
+        uint8_t* levels = arrowBinner.levels(visibleArrows);
+        pool.parallelFor(visibleArrows, LOD_GRAIN, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const Arrow& arrow = arrows[arrowIds ? arrowIds[i] : i];
+                const float depth = std::max(std::min(glm::dot(depthAxis, arrow._origen->_posicion),
+                                                      glm::dot(depthAxis, arrow._destino->_posicion)) + depthOffset,
+                                             1e-3f);
+                levels[i] = lodLevel(ARROW_RADIUS * focal / depth, ARROW_LOD_PIXELS, 3);
+            }
+        });
+        arrowBinner.bin(arrowIds);
+        arrowIds = arrowBinner.ids();
+        for (uint32_t level = 0; level < LodBinner::MAX_LEVELS; ++level) {
+            drawStats.arrowLevels[level] = arrowBinner.count(level);
+        }
+    }
+    
+    // ----- Compactar los datos de instancia -----
+    if (nodeIds) {
+        uploadCompacted<glm::vec3>(sphereBuffers.instanceVBOs[0], sphereBuffers.uploads[0], visibleNodes,
+                                   [&](glm::vec3* dst) { arcane.gatherNodePositions(nodeIds, visibleNodes, dst); });
+        uploadNodeColors(arcane, nodeIds, visibleNodes);
+        if (focusActive) {
+            uploadCompacted<uint8_t>(sphereBuffers.instanceVBOs[2], sphereBuffers.uploads[2], visibleNodes,
+                                     [&](uint8_t* dst) {
+                                         for (uint32_t k = 0; k < visibleNodes; ++k) dst[k] = sphereFocusMask[nodeIds[k]];
+                                     });
+        }
+    } else {
+        // Orden original (impostores sin culling): subida por versiones, sin anillo
+        uploadInstances<glm::vec3>(sphereBuffers.instanceVBOs[0], sphereBuffers.uploads[0],
+                                   arcane.getInstanceVersion(InstanceData::NodePositions), numNodes,
+                                   [&](uint32_t first, uint32_t size, glm::vec3* dst) {
+                                       arcane.writeNodePositions(first, size, dst);
+                                   });
+        uploadNodeColors(arcane, nullptr, numNodes);
+        if (focusActive && sphereBuffers.uploads[2].count != sphereFocusMask.size()) uploadFocusMasks();
+    }
+    
+    if (endpoints) {
+        uploadCompacted<ArrowEndpoints>(arrowBuffers.instanceVBOs[3], arrowBuffers.uploads[3], visibleArrows,
+                                        [&](ArrowEndpoints* dst) {
+                                            arcane.gatherArrowEndpoints(arrowIds, visibleArrows, dst);
+                                        });
+    } else {
+        uploadCompacted<glm::mat4>(arrowBuffers.instanceVBOs[0], arrowBuffers.uploads[0], visibleArrows,
+                                   [&](glm::mat4* dst) { arcane.gatherArrowTransforms(arrowIds, visibleArrows, dst); });
+    }
+    uploadArrowColors(arcane, arrowIds, visibleArrows);
+    if (focusActive) {
+        uploadCompacted<uint8_t>(arrowBuffers.instanceVBOs[2], arrowBuffers.uploads[2], visibleArrows,
+                                 [&](uint8_t* dst) {
+                                     for (uint32_t k = 0; k < visibleArrows; ++k) dst[k] = arrowFocusMask[arrowIds[k]];
+                                 });
+    }
+    
+    lastCompact = key;
+    compactValid = true;
+    if (culling) {
+        cullStats.visibleNodes = visibleNodes;
+        cullStats.totalNodes = numNodes;
+        cullStats.visibleArrows = visibleArrows;
+        cullStats.totalArrows = numArrows;
+        cullStats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void Renderer::updateGpuInstances(const Arcane& arcane) {
+    const uint32_t numNodes = arcane.getNumNodes();
+    const uint32_t numArrows = arcane.getNumArrows();
+    
+    // Datos completos en el orden de Arcane, subidos por versiones: con la red
+    // estática el frame no sube nada aunque se mueva la cámara
+    uploadInstances<glm::vec3>(sphereBuffers.instanceVBOs[0], sphereBuffers.uploads[0],
+                               arcane.getInstanceVersion(InstanceData::NodePositions), numNodes,
+                               [&](uint32_t first, uint32_t size, glm::vec3* dst) {
+                                   arcane.writeNodePositions(first, size, dst);
+                               });
+    uploadNodeColors(arcane, nullptr, numNodes);
+    uploadInstances<ArrowEndpoints>(arrowBuffers.instanceVBOs[3], arrowBuffers.uploads[3],
+                                    arcane.getInstanceVersion(InstanceData::ArrowEndpoints), numArrows,
+                                    [&](uint32_t first, uint32_t size, ArrowEndpoints* dst) {
+                                        arcane.writeArrowEndpoints(first, size, dst);
+                                    });
+    uploadArrowColors(arcane, nullptr, numArrows);
+    
+    // Máscaras compactadas por el camino de CPU
+    if (focusActive && (sphereBuffers.uploads[2].count != sphereFocusMask.size() ||
+                        arrowBuffers.uploads[2].count != arrowFocusMask.size())) {
+        uploadFocusMasks();
+    }
+}
+
+void Renderer::cullOnGpu(const Arcane& arcane) {
+    readGpuStats();
+    
+    GLint viewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    shaderManager->use(cullProgram.program);
+    shaderManager->setUniform(cullProgram.viewProjection, projection * view);
+    shaderManager->setUniform(cullProgram.depthAxis, glm::vec3(-view[0][2], -view[1][2], -view[2][2]));
+    shaderManager->setUniform(cullProgram.depthOffset, -view[3][2]);
+    shaderManager->setUniform(cullProgram.focal, projection[1][1] * static_cast<float>(viewport[3]) * 0.5f);
+    shaderManager->setUniform(cullProgram.culling, culling ? 1 : 0);
+    
+    auto dispatch = [&](IndirectBuffers& buffers, const MeshBuffers& mesh, GLuint geometry, uint32_t count,
+                        bool arrows, float radius, const float* thresholds, int levels, bool impostors) {
+        buffers.reserve(count);
+        
+        // Comandos con instanceCount a 0: el compute shader los cuenta. Se
+        // sustituye el almacenamiento entero para no esperar a los dibujos
+        // del frame anterior, que aún lo leen.
+        IndirectCommands commands{};
+        for (uint32_t level = 0; level < mesh.lodCount; ++level) {
+            const LodMesh& lod = mesh.lods[level];
+            commands.elements[level] = {static_cast<GLuint>(lod.indexCount), 0,
+                                        static_cast<GLuint>(lod.indexOffset / sizeof(MeshIndex)),
+                                        lod.baseVertex, level * buffers.capacity};
+        }
+        commands.arrays = {4, 0, 0, 0};
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers.commands);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(commands), &commands, GL_DYNAMIC_DRAW);
+        if (count == 0) return;
+        
+        glm::vec3 levelPixels(0.0f);
+        for (int level = 0; level < levels; ++level) levelPixels[level] = thresholds[level];
+        
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, geometry);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buffers.ids);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, buffers.commands);
+        shaderManager->setUniform(cullProgram.radius, radius);
+        shaderManager->setUniform(cullProgram.thresholds, levelPixels);
+        shaderManager->setUniform(cullProgram.levels, levels);
+        shaderManager->setUniform(cullProgram.count, static_cast<int>(count));
+        shaderManager->setUniform(cullProgram.capacity, static_cast<int>(buffers.capacity));
+        shaderManager->setUniform(cullProgram.commandBase, impostors ? ARRAYS_COMMAND_WORD : 0);
+        shaderManager->setUniform(cullProgram.arrows, arrows ? 1 : 0);
+        
+        // Más de 65535 grupos: filas de grupos en Y
+        const uint32_t groups = (count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+        glDispatchCompute(std::min(groups, MAX_CULL_GROUPS), (groups + MAX_CULL_GROUPS - 1) / MAX_CULL_GROUPS, 1);
+    };
+    
+    const bool impostors = (sphereMode == SphereRenderMode::Impostor);
+    const bool sphereLevels = levelOfDetail && !impostors;
+    dispatch(sphereIndirect, sphereBuffers, sphereBuffers.instanceVBOs[0], arcane.getNumNodes(),
+             false, NODE_RADIUS, SPHERE_LOD_PIXELS, sphereLevels ? 2 : 0, impostors);
+    dispatch(arrowIndirect, arrowBuffers, arrowBuffers.instanceVBOs[3], arcane.getNumArrows(),
+             true, ARROW_RADIUS, ARROW_LOD_PIXELS, levelOfDetail ? 3 : 0, false);
+    
+    // Ids leídos como atributo, comandos como argumentos de dibujo y copia para las estadísticas
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    
+    cullStats.totalNodes = arcane.getNumNodes();
+    cullStats.totalArrows = arcane.getNumArrows();
+}
+
+void Renderer::readGpuStats() {
+    // Solo si la copia de un frame anterior ya terminó: nunca espera a la GPU
+    if (!gpuStatsFence) return;
+    if (glClientWaitSync(gpuStatsFence, 0, 0) == GL_TIMEOUT_EXPIRED) return;
+    glDeleteSync(gpuStatsFence);
+    gpuStatsFence = nullptr;
+    
+    IndirectCommands nodes{}, arrows{};
+    glBindBuffer(GL_COPY_READ_BUFFER, sphereIndirect.readback);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(nodes), &nodes);
+    glBindBuffer(GL_COPY_READ_BUFFER, arrowIndirect.readback);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(arrows), &arrows);
+    
+    cullStats.visibleNodes = nodes.arrays.instanceCount;
+    cullStats.visibleArrows = 0;
+    for (uint32_t level = 0; level < LodBinner::MAX_LEVELS; ++level) {
+        drawStats.nodeLevels[level] = nodes.elements[level].instanceCount;
+        drawStats.arrowLevels[level] = arrows.elements[level].instanceCount;
+        cullStats.visibleNodes += nodes.elements[level].instanceCount;
+        cullStats.visibleArrows += arrows.elements[level].instanceCount;
+    }
+    drawStats.nodeLevels[0] += nodes.arrays.instanceCount;
+}
+
+void Renderer::drawIndirect(const IndirectBuffers& buffers, const MeshBuffers& mesh, uint32_t levels) {
+    glBindVertexArray(buffers.VAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers.commands);
+    
+    // Niveles consecutivos con la misma primitiva en un solo multi draw
+    uint32_t first = 0;
+    while (first < levels) {
+        uint32_t last = first + 1;
+        while (last < levels && mesh.lods[last].primitive == mesh.lods[first].primitive) ++last;
+        glMultiDrawElementsIndirect(mesh.lods[first].primitive, MESH_INDEX_TYPE,
+                                    (void*)(first * sizeof(DrawElementsIndirectCommand)),
+                                    static_cast<GLsizei>(last - first), 0);
+        ++drawStats.drawCalls;
+        first = last;
+    }
+    glBindVertexArray(0);
+}
+
+void Renderer::setFocus(const Arcane& arcane, const Neighborhood& focus) {
+    sphereFocusMask.assign(arcane.getNumNodes(), 0);
+    arrowFocusMask.assign(arcane.getNumArrows(), 0);
+    for (uint32_t id : focus.nodes) {
+        sphereFocusMask[id] = 255;
+    }
+    for (uint32_t index : focus.arrows) {
+        arrowFocusMask[index] = 255;
+    }
+    
+    // Subir máscaras y activar el atributo en ambos VAO
+    // (con culling se compactan en el siguiente render)
+    uploadFocusMasks();
+    ++focusGeneration;
+    
+    glBindVertexArray(sphereBuffers.VAO);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(arrowBuffers.VAO);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    
+    focusActive = true;
+}
+
+void Renderer::uploadFocusMasks() {
+    uploadFocusMask(sphereBuffers.instanceVBOs[2], sphereFocusMask);
+    sphereBuffers.uploads[2].capacity = static_cast<uint32_t>(sphereFocusMask.size());
+    sphereBuffers.uploads[2].count = sphereBuffers.uploads[2].capacity;     // Máscara completa, sin compactar
+    
+    uploadFocusMask(arrowBuffers.instanceVBOs[2], arrowFocusMask);
+    arrowBuffers.uploads[2].capacity = static_cast<uint32_t>(arrowFocusMask.size());
+    arrowBuffers.uploads[2].count = arrowBuffers.uploads[2].capacity;
+}
+
+void Renderer::clearFocus() {
+    if (!focusActive) return;
+    ++focusGeneration;
+    
+    glBindVertexArray(sphereBuffers.VAO);
+    glDisableVertexAttribArray(1);
+    glBindVertexArray(arrowBuffers.VAO);
+    glDisableVertexAttribArray(1);
+    glBindVertexArray(0);
+    
+    focusActive = false;
+}
+
 void Renderer::render(const Arcane& arcane) {
     // Limpiar buffers
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
-    // Actualizar datos de instancias
-    updateSphereInstances(arcane);
-    updateArrowInstances(arcane);
+    // El programa activo pudo cambiar fuera (ImGui): un glUseProgram por frame
+    shaderManager->invalidateCurrent();
+    
+    // Una máscara de otra red (regenerada) ya no es válida
+    if (focusActive && (sphereFocusMask.size() != arcane.getNumNodes() ||
+                        arrowFocusMask.size() != arcane.getNumArrows())) {
+        clearFocus();
+    }
     
-    auto nodePositions = arcane.getNodePositions();
-    auto arrowTransforms = arcane.getArrowTransforms();
+    // Recuentos leídos directamente de Arcane: el frame no reserva memoria
+    uint32_t numNodes = arcane.getNumNodes();
+    uint32_t numArrows = arcane.getNumArrows();
+    
+    // Actualizar datos de instancias: compactadas (visibles / por nivel), o los rangos modificados
+    Profiler& profiler = Profiler::instance();
+    const bool profiling = profiler.enabled();
+    const bool indirect = gpuDriven();
+    uploadedBytes = 0;
+    {
+        Profiler::Scope scope(phases.instances);
+        MULTIVERSO_TRACE_SCOPE("render", "Instancias");
+        if (indirect) {
+            updateGpuInstances(arcane);
+            if (profiling) gpuTimer.begin(GPU_CULLING);
+            cullOnGpu(arcane);
+            gpuTimer.end();
+        } else if (compacting()) {
+            compactInstances(arcane);
+        } else {
+            updateSphereInstances(arcane);
+            updateArrowInstances(arcane);
+            drawStats.nodeLevels = {numNodes};
+            drawStats.arrowLevels = {numArrows};
+        }
+    }
+    
+    // Con culling en GPU los recuentos por nivel llegan con retraso: se dibuja
+    // siempre y los comandos sin instancias no cuestan nada
+    if (!indirect) {
+        numNodes = 0;
+        numArrows = 0;
+        for (uint32_t level = 0; level < LodBinner::MAX_LEVELS; ++level) {
+            numNodes += drawStats.nodeLevels[level];
+            numArrows += drawStats.arrowLevels[level];
+        }
+    }
+    drawStats.triangles = 0;
+    drawStats.lines = 0;
+    drawStats.drawCalls = 0;
     
     // Renderizar flechas si hay datos
-    if (!arrowTransforms.empty()) {
-        shaderManager->useShader("arrow");
-        GLuint arrowProgram = shaderManager->getShaderProgram("arrow");
+    if (numArrows > 0 || drawStats.bundles > 0) {
+        Profiler::Scope scope(phases.arrows);
+        MULTIVERSO_TRACE_SCOPE("render", "Flechas");
+        if (profiling) gpuTimer.begin(GPU_ARROWS);
+        
+        const ProgramUniforms& arrow = indirect ? arrowIndirectProgram
+                                     : (arrowMode == ArrowRenderMode::Endpoints) ? arrowEndpointsProgram
+                                                                                 : arrowProgram;
+        shaderManager->use(arrow.program);
+        shaderManager->setUniform(arrow.view, view);
+        shaderManager->setUniform(arrow.projection, projection);
         
-        GLint viewLoc = glGetUniformLocation(arrowProgram, "view");
-        GLint projLoc = glGetUniformLocation(arrowProgram, "projection");
+        // Solo en el programa de extremos: mismos valores por defecto que Arrow::updateTransform
+        shaderManager->setUniform(arrow.sphereRadius, 0.2f);
+        shaderManager->setUniform(arrow.thickness, 1.0f);
+        setColorUniforms(arrow, arcane, Arcane::ARROW_SHADE);
         
-        if (viewLoc != -1 && projLoc != -1) {
-            glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        if (indirect) {
+            // Los niveles de triángulos en un multi draw y las líneas en otro
+            shaderManager->setUniform(arrow.focusActive, focusActive ? 1 : 0);
+            bindInstanceStorage(arrowBuffers.instanceVBOs[3], arrowBuffers.instanceVBOs[paletteColors ? 4 : 1],
+                                paletteColors, focusActive ? arrowBuffers.instanceVBOs[2] : 0);
+            drawIndirect(arrowIndirect, arrowBuffers, levelOfDetail ? arrowBuffers.lodCount : 1);
+            for (uint32_t level = 0; level < arrowBuffers.lodCount; ++level) {
+                const LodMesh& mesh = arrowBuffers.lods[level];
+                if (mesh.primitive == GL_LINES) drawStats.lines += drawStats.arrowLevels[level];
+                else drawStats.triangles += static_cast<uint64_t>(mesh.indexCount / 3) * drawStats.arrowLevels[level];
+            }
+        } else {
+            // Un rango instanciado por nivel; sin base instance (GL 3.3) se
+            // desplazan los punteros de los atributos de instancia
+            glBindVertexArray(arrowBuffers.VAO);
+            uint32_t first = 0;
+            for (uint32_t level = 0; level < arrowBuffers.lodCount; ++level) {
+                const uint32_t count = drawStats.arrowLevels[level];
+                if (count == 0) continue;
+                if (first > 0) pointArrowInstances(first);
+                arrowBuffers.draw(level, count);
+                ++drawStats.drawCalls;
+                
+                const LodMesh& mesh = arrowBuffers.lods[level];
+                if (mesh.primitive == GL_LINES) drawStats.lines += count;
+                else drawStats.triangles += static_cast<uint64_t>(mesh.indexCount / 3) * count;
+                first += count;
+            }
+            if (first > drawStats.arrowLevels[0]) pointArrowInstances(0);
+            glBindVertexArray(0);
         }
         
-        glBindVertexArray(arrowBuffers.VAO);
-        auto arrowIndices = Geometry::generateArrowIndices();
-        glDrawElementsInstanced(GL_TRIANGLES, 
-                               static_cast<GLsizei>(arrowIndices.size()),
-                               GL_UNSIGNED_INT, 0,
-                               static_cast<GLsizei>(arrowTransforms.size()));
-        glBindVertexArray(0);
+        // Haces cerrados: malla de flecha de más detalle con colores RGB propios
+        if (drawStats.bundles > 0) {
+            shaderManager->use(arrowProgram.program);
+            shaderManager->setUniform(arrowProgram.view, view);
+            shaderManager->setUniform(arrowProgram.projection, projection);
+            shaderManager->setUniform(arrowProgram.paletteColors, 0);
+            glBindVertexArray(bundleBuffers.VAO);
+            arrowBuffers.draw(0, drawStats.bundles);
+            glBindVertexArray(0);
+            ++drawStats.drawCalls;
+            drawStats.triangles += static_cast<uint64_t>(arrowBuffers.lods[0].indexCount / 3) * drawStats.bundles;
+        }
+        gpuTimer.end();
     }
     
     // Renderizar esferas si hay datos
-    if (!nodePositions.empty()) {
-        shaderManager->useShader("sphere");
-        GLuint sphereProgram = shaderManager->getShaderProgram("sphere");
+    {
+        Profiler::Scope scope(phases.spheres);
+        MULTIVERSO_TRACE_SCOPE("render", "Esferas");
+        if (profiling && numNodes > 0) gpuTimer.begin(GPU_SPHERES);
+        
+        if (numNodes > 0 && indirect) {
+            const bool impostors = (sphereMode == SphereRenderMode::Impostor);
+            const ProgramUniforms& sphere = impostors ? impostorIndirectProgram : sphereIndirectProgram;
+            shaderManager->use(sphere.program);
+            shaderManager->setUniform(sphere.view, view);
+            shaderManager->setUniform(sphere.projection, projection);
+            shaderManager->setUniform(sphere.mvp, projection * view);
+            shaderManager->setUniform(sphere.radius, NODE_RADIUS);
+            shaderManager->setUniform(sphere.focusActive, focusActive ? 1 : 0);
+            setColorUniforms(sphere, arcane, 1.0f);
+            bindInstanceStorage(sphereBuffers.instanceVBOs[0], sphereBuffers.instanceVBOs[paletteColors ? 4 : 1],
+                                paletteColors, focusActive ? sphereBuffers.instanceVBOs[2] : 0);
+            
+            if (impostors) {
+                glBindVertexArray(sphereIndirect.VAO);
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, sphereIndirect.commands);
+                glDrawArraysIndirect(GL_TRIANGLE_STRIP, (void*)offsetof(IndirectCommands, arrays));
+                glBindVertexArray(0);
+                drawStats.triangles += 2ull * drawStats.nodeLevels[0];
+                ++drawStats.drawCalls;
+            } else {
+                drawIndirect(sphereIndirect, sphereBuffers, levelOfDetail ? sphereBuffers.lodCount : 1);
+                for (uint32_t level = 0; level < sphereBuffers.lodCount; ++level) {
+                    drawStats.triangles += static_cast<uint64_t>(sphereBuffers.lods[level].indexCount / 3) *
+                                           drawStats.nodeLevels[level];
+                }
+            }
+        } else if (numNodes > 0 && sphereMode == SphereRenderMode::Impostor) {
+            shaderManager->use(impostorProgram.program);
+            shaderManager->setUniform(impostorProgram.view, view);
+            shaderManager->setUniform(impostorProgram.projection, projection);
+            shaderManager->setUniform(impostorProgram.radius, NODE_RADIUS);
+            setColorUniforms(impostorProgram, arcane, 1.0f);
+        
+            // Mismo VAO (atributos de instancia), pero solo 4 vértices por nodo
+            glBindVertexArray(sphereBuffers.VAO);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(numNodes));
+            glBindVertexArray(0);
+            drawStats.triangles += 2ull * numNodes;
+            ++drawStats.drawCalls;
+        } else if (numNodes > 0) {
+            shaderManager->use(sphereProgram.program);
+            shaderManager->setUniform(sphereProgram.mvp, projection * view);
+            setColorUniforms(sphereProgram, arcane, 1.0f);
         
-        GLint mvpLoc = glGetUniformLocation(sphereProgram, "mvp");
-        if (mvpLoc != -1) {
-            glm::mat4 mvp = projection * view;
-            glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp));
+            glBindVertexArray(sphereBuffers.VAO);
+            uint32_t first = 0;
+            for (uint32_t level = 0; level < sphereBuffers.lodCount; ++level) {
+                const uint32_t count = drawStats.nodeLevels[level];
+                if (count == 0) continue;
+                if (first > 0) pointSphereInstances(first);
+                sphereBuffers.draw(level, count);
+                ++drawStats.drawCalls;
+                drawStats.triangles += static_cast<uint64_t>(sphereBuffers.lods[level].indexCount / 3) * count;
+                first += count;
+            }
+            if (first > drawStats.nodeLevels[0]) pointSphereInstances(0);
+            glBindVertexArray(0);
         }
+        gpuTimer.end();
+    }
+    
+    // Resultados de GPU del frame anterior, sin esperar
+    if (profiling) {
+        gpuTimer.endFrame();
+        profiler.record(phases.gpuArrows, gpuTimer.milliseconds(GPU_ARROWS));
+        profiler.record(phases.gpuSpheres, gpuTimer.milliseconds(GPU_SPHERES));
+        if (indirect) profiler.record(phases.gpuCulling, gpuTimer.milliseconds(GPU_CULLING));
+    }
+    if (indirect) {
+        cullStats.milliseconds = profiling ? gpuTimer.milliseconds(GPU_CULLING) : 0.0;
         
-        glBindVertexArray(sphereBuffers.VAO);
-        auto sphereIndices = Geometry::generateSphereIndices();
-        glDrawElementsInstanced(GL_TRIANGLES,
-                               static_cast<GLsizei>(sphereIndices.size()),
-                               GL_UNSIGNED_INT, 0,
-                               static_cast<GLsizei>(nodePositions.size()));
-        glBindVertexArray(0);
+        // Recuentos de este frame para las estadísticas, leídos cuando la GPU termine
+        if (!gpuStatsFence) {
+            for (const IndirectBuffers* buffers : {&sphereIndirect, &arrowIndirect}) {
+                glBindBuffer(GL_COPY_READ_BUFFER, buffers->commands);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffers->readback);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(IndirectCommands));
+            }
+            gpuStatsFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+    
+    // Las regiones escritas este frame no se reutilizan hasta que la GPU las lea
+    if (streaming && !compacting()) {
+        if (numNodes > 0) sphereStream.fence();
+        if (numArrows > 0) arrowStream.fence();
     }
     
     // Verificar errores de OpenGL
@@ -223,6 +1327,16 @@ void Renderer::render(const Arcane& arcane) {
 }
 
 void Renderer::cleanup() {
+    if (gpuStatsFence) {
+        glDeleteSync(gpuStatsFence);
+        gpuStatsFence = nullptr;
+    }
+    sphereIndirect.cleanup();
+    arrowIndirect.cleanup();
+    bundleBuffers.cleanup();
+    gpuTimer.destroy();
+    sphereStream.destroy();
+    arrowStream.destroy();
     sphereBuffers.cleanup();
     arrowBuffers.cleanup();
     
@@ -231,10 +1345,54 @@ void Renderer::cleanup() {
     }
 }
 
+uint32_t Renderer::getSphereTriangles() const noexcept {
+    if (sphereMode == SphereRenderMode::Impostor) return 2;
+    return static_cast<uint32_t>(sphereBuffers.indexCount / 3);
+}
+
 glm::mat4 Renderer::calculateProjection(float aspectRatio) noexcept {
     return glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
 }
 
+void Renderer::MeshBuffers::uploadLods(std::initializer_list<LodSource> sources) {
+    // Rangos de cada nivel; los datos se copian directamente de las mallas constexpr
+    GLsizeiptr vertexBytes = 0;
+    GLsizeiptr indexBytes = 0;
+    lodCount = 0;
+    for (const LodSource& source : sources) {
+        if (lodCount == lods.size()) break;
+        LodMesh& mesh = lods[lodCount++];
+        mesh.primitive = source.primitive;
+        mesh.indexCount = static_cast<GLsizei>(source.indices.size());
+        mesh.indexOffset = static_cast<GLintptr>(indexBytes);
+        mesh.baseVertex = static_cast<GLint>(vertexBytes / (3 * sizeof(float)));
+        vertexBytes += static_cast<GLsizeiptr>(source.vertices.size_bytes());
+        indexBytes += static_cast<GLsizeiptr>(source.indices.size_bytes());
+    }
+    indexCount = lods[0].indexCount;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, nullptr, GL_STATIC_DRAW);
+    
+    uint32_t level = 0;
+    for (const LodSource& source : sources) {
+        if (level == lodCount) break;
+        const LodMesh& mesh = lods[level++];
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(mesh.baseVertex) * 3 * sizeof(float),
+                        static_cast<GLsizeiptr>(source.vertices.size_bytes()), source.vertices.data());
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.indexOffset,
+                        static_cast<GLsizeiptr>(source.indices.size_bytes()), source.indices.data());
+    }
+}
+
+void Renderer::MeshBuffers::draw(uint32_t level, uint32_t instances) const noexcept {
+    const LodMesh& mesh = lods[level];
+    glDrawElementsInstancedBaseVertex(mesh.primitive, mesh.indexCount, MESH_INDEX_TYPE,
+                                      (void*)mesh.indexOffset, static_cast<GLsizei>(instances), mesh.baseVertex);
+}
+
 void Renderer::MeshBuffers::cleanup() noexcept {
     if (VAO) glDeleteVertexArrays(1, &VAO);
     if (VBO) glDeleteBuffers(1, &VBO);
@@ -243,5 +1401,84 @@ void Renderer::MeshBuffers::cleanup() noexcept {
         if (vbo) glDeleteBuffers(1, &vbo);
     }
     VAO = VBO = EBO = 0;
+    indexCount = 0;
+    lods.fill(LodMesh());
+    lodCount = 0;
     instanceVBOs.fill(0);
+    uploads.fill(InstanceUpload());
+}
+
+void Renderer::IndirectBuffers::setup(const MeshBuffers& mesh) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &ids);
+    glGenBuffers(1, &commands);
+    glGenBuffers(1, &readback);
+    
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(IndirectCommands), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, readback);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(IndirectCommands), nullptr, GL_STREAM_READ);
+    
+    // Misma malla que el camino de GL 3.3; el resto de datos sale de los SSBO
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    
+    // Id de instancia: con divisor 1 se lee en baseInstance + gl_InstanceID
+    glBindBuffer(GL_ARRAY_BUFFER, ids);
+    glVertexAttribIPointer(10, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glEnableVertexAttribArray(10);
+    glVertexAttribDivisor(10, 1);
+    glBindVertexArray(0);
+}
+
+void Renderer::IndirectBuffers::reserve(uint32_t count) {
+    if (count <= capacity) return;
+    capacity = std::max(count, capacity + capacity / 2);
+    glBindBuffer(GL_ARRAY_BUFFER, ids);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity) * LodBinner::MAX_LEVELS * sizeof(GLuint),
+                 nullptr, GL_DYNAMIC_COPY);
+}
+
+void Renderer::BundleBuffers::setup(const MeshBuffers& mesh) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(static_cast<GLsizei>(instanceVBOs.size()), instanceVBOs.data());
+    
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    
+    pointArrowMatrices(instanceVBOs[0], 0);
+    for (int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(4 + i);
+        glVertexAttribDivisor(4 + i, 1);
+    }
+    pointColors(instanceVBOs[1], 0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+}
+
+void Renderer::BundleBuffers::cleanup() noexcept {
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    for (auto& vbo : instanceVBOs) {
+        if (vbo) glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    VAO = 0;
+    uploads = {};
+}
+
+void Renderer::IndirectBuffers::cleanup() noexcept {
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    for (GLuint* buffer : {&ids, &commands, &readback}) {
+        if (*buffer) glDeleteBuffers(1, buffer);
+        *buffer = 0;
+    }
+    VAO = 0;
+    capacity = 0;
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "graphics/ShaderCache.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x4D565342;        // "MVSB"
+    constexpr uint32_t CACHE_VERSION = 1;
+    
+    struct Header {
+        uint32_t magic = CACHE_MAGIC;
+        uint32_t version = CACHE_VERSION;
+        uint64_t key = 0;
+        uint32_t format = 0;        // GL_PROGRAM_BINARY_FORMATS del driver
+        uint32_t length = 0;        // Bytes del binario que siguen a la cabecera
+    };
+    
+    // FNV-1a de 64 bits
+    constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+    
+    uint64_t fnv1a(std::string_view data, uint64_t hash = FNV_OFFSET) noexcept {
+        for (unsigned char c : data) {
+            hash = (hash ^ c) * FNV_PRIME;
+        }
+        // Separador: "ab" + "c" no debe coincidir con "a" + "bc"
+        return (hash ^ 0xFF) * FNV_PRIME;
+    }
+    
+    std::string_view glString(GLenum name) noexcept {
+        const GLubyte* value = glGetString(name);
+        return value ? std::string_view(reinterpret_cast<const char*>(value)) : std::string_view();
+    }
+}
+
+ShaderCache::ShaderCache() : ShaderCache(defaultDirectory()) {}
+
+ShaderCache::ShaderCache(std::filesystem::path directory) : _directory(std::move(directory)) {
+    GLint formats = 0;
+    if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    
+    std::error_code error;
+    if (formats > 0 && !_directory.empty()) {
+        std::filesystem::create_directories(_directory, error);
+        _enabled = !error;
+    }
+    
+    _driverHash = fnv1a(glString(GL_VENDOR));
+    _driverHash = fnv1a(glString(GL_RENDERER), _driverHash);
+    _driverHash = fnv1a(glString(GL_VERSION), _driverHash);
+}
+
+std::filesystem::path ShaderCache::defaultDirectory() {
+#if defined(_WIN32)
+    if (const char* local = std::getenv("LOCALAPPDATA")) {
+        return std::filesystem::path(local) / "Multiverso" / "shaders";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return std::filesystem::path(xdg) / "multiverso" / "shaders";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::filesystem::path(home) / ".cache" / "multiverso" / "shaders";
+    }
+#endif
+    return {};
+}
+
+uint64_t ShaderCache::key(std::string_view vertexSrc, std::string_view fragmentSrc) const noexcept {
+    return fnv1a(fragmentSrc, fnv1a(vertexSrc, _driverHash));
+}
+
+std::filesystem::path ShaderCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return _directory / name;
+}
+
+void ShaderCache::prepare(GLuint program) const noexcept {
+    if (_enabled) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+bool ShaderCache::load(uint64_t key, GLuint program) {
+    if (!_enabled) {
+        ++_misses;
+        return false;
+    }
+    
+    const std::filesystem::path path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ++_misses;
+        return false;
+    }
+    
+    Header header;
+    std::vector<char> binary;
+    bool valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header))) &&
+                 header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key;
+    if (valid) {
+        binary.resize(header.length);
+        valid = static_cast<bool>(file.read(binary.data(), static_cast<std::streamsize>(binary.size())));
+    }
+    file.close();
+    
+    // El driver puede rechazar un binario de otra versión aunque la clave coincida
+    GLint linked = GL_FALSE;
+    if (valid) {
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
+    
+    if (!linked) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        ++_misses;
+        return false;
+    }
+    
+    ++_hits;
+    return true;
+}
+
+void ShaderCache::store(uint64_t key, GLuint program) {
+    if (!_enabled) return;
+    
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    
+    Header header;
+    header.key = key;
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+    
+    // Escribir aparte y renombrar: otra instancia nunca lee un archivo a medias
+    const std::filesystem::path path = pathFor(key);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) std::filesystem::remove(temporary, error);
+}
@@ -1,88 +1,305 @@
 #include "ShaderManager.hpp"
+#include "graphics/ShaderCache.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+namespace {
+    // Palabras de 32 bits de un elemento del tipo de uniform
+    uint32_t uniformWords(GLenum type) noexcept {
+        switch (type) {
+            case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+                return 1;
+            case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+                return 2;
+            case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+                return 3;
+            case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4:
+            case GL_FLOAT_MAT2:
+                return 4;
+            case GL_FLOAT_MAT3:
+                return 9;
+            case GL_FLOAT_MAT4:
+                return 16;
+            default:
+                return 1;       // Samplers y demás: una unidad entera
+        }
+    }
+}
+
+ShaderManager::ShaderManager() = default;
+
+ShaderManager::~ShaderManager() {
+    cleanup();
+}
+
 ShaderManager::ShaderResult ShaderManager::loadShaderProgram(
     std::string_view name, 
     std::string_view vertexSrc, 
     std::string_view fragmentSrc) {
     
-    auto vertexResult = compileShader(GL_VERTEX_SHADER, vertexSrc);
-    if (!vertexResult.success) {
-        return {false, 0, "Vertex shader compilation failed: " + vertexResult.errorMessage};
-    }
-    
-    auto fragmentResult = compileShader(GL_FRAGMENT_SHADER, fragmentSrc);
-    if (!fragmentResult.success) {
-        glDeleteShader(vertexResult.shaderId);
-        return {false, 0, "Fragment shader compilation failed: " + fragmentResult.errorMessage};
+    const ProgramSource source{name, vertexSrc, fragmentSrc};
+    return loadShaderPrograms(std::span<const ProgramSource>(&source, 1)).front();
+}
+
+std::vector<ShaderManager::ShaderResult> ShaderManager::loadShaderPrograms(std::span<const ProgramSource> sources) {
+    if (!_cache) {
+        _cache = std::make_unique<ShaderCache>();
+        
+        // El driver compila y enlaza en sus propios hilos
+        if (GLAD_GL_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        } else if (GLAD_GL_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        }
     }
     
-    auto linkResult = linkProgram(vertexResult.shaderId, fragmentResult.shaderId);
+    struct Pending {
+        GLuint program = 0;
+        GLuint vertex = 0;
+        GLuint fragment = 0;
+        GLuint compute = 0;
+        uint64_t key = 0;
+        bool cached = false;
+    };
+    std::vector<Pending> pending(sources.size());
+    std::vector<ShaderResult> results(sources.size());
     
-    // Limpiar shaders intermedios
-    glDeleteShader(vertexResult.shaderId);
-    glDeleteShader(fragmentResult.shaderId);
+    // 1. Binarios de la caché; el resto se lanza sin consultar ningún estado,
+    //    así las compilaciones de todos los programas se solapan
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const ProgramSource& source = sources[i];
+        Pending& job = pending[i];
+        job.program = glCreateProgram();
+        const bool compute = !source.computeSrc.empty();
+        job.key = compute ? _cache->key(source.computeSrc, {}) : _cache->key(source.vertexSrc, source.fragmentSrc);
+        if (_cache->load(job.key, job.program)) {
+            job.cached = true;
+            continue;
+        }
+        
+        if (compute) {
+            job.compute = compileShader(GL_COMPUTE_SHADER, source.computeSrc);
+            glAttachShader(job.program, job.compute);
+        } else {
+            job.vertex = compileShader(GL_VERTEX_SHADER, source.vertexSrc);
+            job.fragment = compileShader(GL_FRAGMENT_SHADER, source.fragmentSrc);
+            glAttachShader(job.program, job.vertex);
+            glAttachShader(job.program, job.fragment);
+        }
+        _cache->prepare(job.program);
+        glLinkProgram(job.program);
+    }
     
-    if (linkResult.success) {
-        shaderPrograms[std::string(name)] = linkResult.programId;
+    // 2. Resultados: la primera consulta de estado espera a cada programa
+    for (size_t i = 0; i < sources.size(); ++i) {
+        Pending& job = pending[i];
+        ShaderResult& result = results[i];
+        result = {true, job.program, ""};
+        
+        if (!job.cached) {
+            GLint linked = GL_FALSE;
+            glGetProgramiv(job.program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                if (auto log = shaderError(job.vertex)) {
+                    result.errorMessage = "Vertex shader compilation failed: " + *log;
+                } else if (auto log = shaderError(job.fragment)) {
+                    result.errorMessage = "Fragment shader compilation failed: " + *log;
+                } else if (auto log = shaderError(job.compute)) {
+                    result.errorMessage = "Compute shader compilation failed: " + *log;
+                } else {
+                    char infoLog[1024];
+                    glGetProgramInfoLog(job.program, sizeof(infoLog), nullptr, infoLog);
+                    result.errorMessage = infoLog;
+                }
+                result.success = false;
+                result.programId = 0;
+            } else {
+                _cache->store(job.key, job.program);
+            }
+            
+            // Limpiar shaders intermedios
+            for (GLuint shader : {job.vertex, job.fragment, job.compute}) {
+                if (!shader) continue;
+                glDetachShader(job.program, shader);
+                glDeleteShader(shader);
+            }
+        }
+        
+        if (!result.success) {
+            glDeleteProgram(job.program);
+            continue;
+        }
+        result.handle = registerProgram(sources[i].name, job.program);
     }
     
-    return linkResult;
+    return results;
+}
+
+ShaderManager::ProgramHandle ShaderManager::registerProgram(std::string_view name, GLuint id) {
+    // Recargar un nombre sustituye su programa (los handles siguen siendo válidos)
+    auto [it, inserted] = shaderPrograms.try_emplace(std::string(name), static_cast<uint32_t>(_programs.size()));
+    if (inserted) {
+        _programs.emplace_back();
+    } else {
+        glDeleteProgram(_programs[it->second].id);
+        if (_current == it->second) _current = UINT32_MAX;
+    }
+    Program& program = _programs[it->second];
+    program.id = id;
+    program.name = std::string(name);
+    reflectUniforms(it->second);
+    return ProgramHandle{it->second};
 }
 
-ShaderManager::CompileResult ShaderManager::compileShader(GLenum type, std::string_view source) {
+GLuint ShaderManager::compileShader(GLenum type, std::string_view source) {
     GLuint shader = glCreateShader(type);
     const char* sourcePtr = source.data();
-    glShaderSource(shader, 1, &sourcePtr, nullptr);
+    const GLint length = static_cast<GLint>(source.size());
+    glShaderSource(shader, 1, &sourcePtr, &length);
     glCompileShader(shader);
-    
+    return shader;
+}
+
+std::optional<std::string> ShaderManager::shaderError(GLuint shader) {
+    if (!shader) return std::nullopt;       // Etapa que el programa no tiene
     int success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success) return std::nullopt;
     
-    if (!success) {
-        char infoLog[1024];
-        glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-        glDeleteShader(shader);
-        return {false, 0, std::string(infoLog)};
-    }
-    
-    return {true, shader, ""};
+    char infoLog[1024];
+    glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
+    return std::string(infoLog);
 }
 
-ShaderManager::ShaderResult ShaderManager::linkProgram(GLuint vertexShader, GLuint fragmentShader) {
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
+void ShaderManager::reflectUniforms(uint32_t index) {
+    Program& program = _programs[index];
     
-    int success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    // Los uniforms de una recarga sustituyen a los anteriores; sus valores
+    // en caché se descartan (los handles antiguos apuntan a entradas muertas)
+    program.uniforms.clear();
     
-    if (!success) {
-        char infoLog[1024];
-        glGetProgramInfoLog(program, 1024, nullptr, infoLog);
-        glDeleteProgram(program);
-        return {false, 0, std::string(infoLog)};
-    }
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program.id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program.id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string buffer(static_cast<size_t>(std::max(maxLength, 1)), '\0');
     
-    return {true, program, ""};
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program.id, static_cast<GLuint>(i), maxLength, &length, &size, &type, buffer.data());
+        
+        // Los arrays se publican como "nombre[0]"
+        std::string name(buffer.data(), static_cast<size_t>(length));
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            name.resize(name.size() - 3);
+        }
+        
+        // Uniforms de bloques: sin location propia
+        GLint location = glGetUniformLocation(program.id, name.c_str());
+        if (location < 0) continue;
+        
+        Uniform uniform;
+        uniform.location = location;
+        uniform.type = type;
+        uniform.program = index;
+        uniform.offset = static_cast<uint32_t>(_values.size());
+        uniform.words = uniformWords(type) * static_cast<uint32_t>(std::max(size, 1));
+        _values.resize(_values.size() + uniform.words, 0);
+        
+        program.uniforms[name] = static_cast<uint32_t>(_uniforms.size());
+        _uniforms.push_back(uniform);
+    }
 }
 
-GLuint ShaderManager::getShaderProgram(std::string_view name) const {
+ShaderManager::ProgramHandle ShaderManager::findProgram(std::string_view name) const {
     auto it = shaderPrograms.find(std::string(name));
-    return (it != shaderPrograms.end()) ? it->second : 0;
+    return (it != shaderPrograms.end()) ? ProgramHandle{it->second} : ProgramHandle{};
 }
 
-void ShaderManager::useShader(std::string_view name) const {
-    GLuint program = getShaderProgram(name);
-    if (program) {
-        glUseProgram(program);
+ShaderManager::UniformHandle ShaderManager::findUniform(ProgramHandle program, std::string_view name) const {
+    if (!program.valid()) return {};
+    const auto& uniforms = _programs[program.index].uniforms;
+    auto it = uniforms.find(std::string(name));
+    return (it != uniforms.end()) ? UniformHandle{it->second} : UniformHandle{};
+}
+
+GLuint ShaderManager::getProgramId(ProgramHandle program) const noexcept {
+    return program.valid() ? _programs[program.index].id : 0;
+}
+
+GLuint ShaderManager::getShaderProgram(std::string_view name) const {
+    return getProgramId(findProgram(name));
+}
+
+void ShaderManager::use(ProgramHandle program) {
+    if (!program.valid() || program.index == _current) return;
+    glUseProgram(_programs[program.index].id);
+    _current = program.index;
+}
+
+bool ShaderManager::changed(UniformHandle handle, const void* value, uint32_t words) {
+    if (!handle.valid()) return false;
+    Uniform& uniform = _uniforms[handle.index];
+    
+    const size_t bytes = static_cast<size_t>(std::min(words, uniform.words)) * sizeof(uint32_t);
+    uint32_t* cached = &_values[uniform.offset];
+    if (uniform.initialized && std::memcmp(cached, value, bytes) == 0) {
+        ++_skips;
+        return false;
+    }
+    
+    std::memcpy(cached, value, bytes);
+    uniform.initialized = true;
+    use(ProgramHandle{uniform.program});
+    ++_uploads;
+    return true;
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, int value) {
+    if (changed(uniform, &value, 1)) glUniform1i(_uniforms[uniform.index].location, value);
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, float value) {
+    if (changed(uniform, &value, 1)) glUniform1f(_uniforms[uniform.index].location, value);
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, const glm::vec3& value) {
+    if (changed(uniform, glm::value_ptr(value), 3)) {
+        glUniform3fv(_uniforms[uniform.index].location, 1, glm::value_ptr(value));
+    }
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, const glm::vec4& value) {
+    if (changed(uniform, glm::value_ptr(value), 4)) {
+        glUniform4fv(_uniforms[uniform.index].location, 1, glm::value_ptr(value));
+    }
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, const glm::mat4& value) {
+    if (changed(uniform, glm::value_ptr(value), 16)) {
+        glUniformMatrix4fv(_uniforms[uniform.index].location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+void ShaderManager::setUniform(UniformHandle uniform, const glm::vec3* values, uint32_t count) {
+    if (!uniform.valid()) return;
+    count = std::min(count, _uniforms[uniform.index].words / 3);
+    if (count == 0) return;
+    if (changed(uniform, values, count * 3)) {
+        glUniform3fv(_uniforms[uniform.index].location, static_cast<GLsizei>(count), glm::value_ptr(values[0]));
     }
 }
 
 void ShaderManager::cleanup() {
-    for (auto& [name, program] : shaderPrograms) {
-        glDeleteProgram(program);
+    for (const Program& program : _programs) {
+        if (program.id) glDeleteProgram(program.id);
     }
     shaderPrograms.clear();
-}
\ No newline at end of file
+    _programs.clear();
+    _uniforms.clear();
+    _values.clear();
+    _current = UINT32_MAX;
+}
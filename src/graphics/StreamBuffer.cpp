@@ -0,0 +1,100 @@
+#include "graphics/StreamBuffer.hpp"
+
+#include <algorithm>
+
+namespace {
+    constexpr GLuint64 FENCE_TIMEOUT_NS = 1'000'000;     // Reintentos de 1 ms
+}
+
+bool StreamBuffer::persistentSupported() noexcept {
+    return GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+}
+
+void StreamBuffer::reserve(GLsizeiptr regionBytes) {
+    if (regionBytes <= _regionSize && _buffer) return;
+
+    // Crecimiento geométrico: no recrear en cada pequeño aumento
+    const GLsizeiptr size = std::max(regionBytes, _regionSize + _regionSize / 2);
+    destroy();
+
+    _persistent = persistentSupported();
+    _regionSize = size;
+    glGenBuffers(1, &_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+
+    if (_persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size * REGIONS, nullptr, flags);
+        _persistentPtr = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size * REGIONS, flags));
+        if (!_persistentPtr) {
+            // Sin mapeo persistente: almacenamiento mutable y mapeo por frame
+            glDeleteBuffers(1, &_buffer);
+            glGenBuffers(1, &_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            _persistent = false;
+        }
+    }
+
+    if (!_persistent) {
+        glBufferData(GL_ARRAY_BUFFER, size * REGIONS, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+void* StreamBuffer::map() {
+    _region = (_region + 1) % REGIONS;
+    waitRegion(_region);
+
+    const GLintptr offset = _regionSize * _region;
+    if (_persistent) {
+        return _persistentPtr + offset;
+    }
+
+    // La región ya no la lee la GPU (fence), no hace falta sincronizar
+    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    return glMapBufferRange(GL_ARRAY_BUFFER, offset, _regionSize,
+                            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+GLintptr StreamBuffer::unmap() {
+    if (!_persistent) {
+        glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    return _regionSize * _region;
+}
+
+void StreamBuffer::fence() {
+    if (_fences[_region]) glDeleteSync(_fences[_region]);
+    _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::waitRegion(uint32_t region) {
+    GLsync& sync = _fences[region];
+    if (!sync) return;
+
+    GLenum result = glClientWaitSync(sync, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+    }
+    glDeleteSync(sync);
+    sync = nullptr;
+}
+
+void StreamBuffer::destroy() noexcept {
+    for (GLsync& sync : _fences) {
+        if (sync) glDeleteSync(sync);
+        sync = nullptr;
+    }
+    if (_buffer) {
+        if (_persistent && _persistentPtr) {
+            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &_buffer);
+    }
+    _buffer = 0;
+    _regionSize = 0;
+    _region = REGIONS - 1;
+    _persistentPtr = nullptr;
+    _persistent = false;
+}
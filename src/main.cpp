@@ -1,15 +1,32 @@
 #include "core/Arcane.hpp"
-#include "graphics/Renderer.hpp"
+#include "core/Centrality.hpp"
+#include "core/ForceLayout.hpp"
+#include "core/Octree.hpp"
+#include "graphics/RenderThread.hpp"
 #include "ui/GUI.hpp"
 #include "utils/Camera.hpp"
+#include "utils/Headless.hpp"
+#include "utils/AllocCounter.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/Trace.hpp"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <chrono>
+#include <ctime>
+#include <string>
 
 // Variables globales para input
 double mouseX = 0.0, mouseY = 0.0;
 double scrollY = 0.0;
 bool mousePressed = false;
+bool pickRequested = false;
+int pickButton = GLFW_MOUSE_BUTTON_LEFT;
+double pressX = 0.0, pressY = 0.0;
+bool traceToggleRequested = false;
+bool traceDumpRequested = false;
 
 // Callbacks globales
 void mouseCallback(GLFWwindow* window, double xpos, double ypos) {
@@ -25,9 +42,45 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
         mousePressed = (action == GLFW_PRESS);
     }
+    
+    // Clic sin arrastrar (el arrastre orbita la cámara): picking del nodo bajo el cursor
+    if (action == GLFW_PRESS) {
+        pressX = mouseX;
+        pressY = mouseY;
+    } else if (action == GLFW_RELEASE && std::abs(mouseX - pressX) + std::abs(mouseY - pressY) < 4.0) {
+        pickRequested = true;
+        pickButton = button;
+    }
+}
+
+// F8: grabar / pausar la traza, F9: exportarla
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (action != GLFW_PRESS) return;
+    if (key == GLFW_KEY_F8) traceToggleRequested = true;
+    if (key == GLFW_KEY_F9) traceDumpRequested = true;
+}
+
+// Traza de Chrome en el directorio actual, con la hora para no sobrescribir
+void writeTrace() {
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = std::string("multiverso-trace-") + stamp + ".json";
+    
+    if (Trace::write(path)) {
+        std::cout << "Traza guardada en " << path << " (" << Trace::eventCount() << " eventos, "
+                  << Trace::dropped() << " descartados)" << std::endl;
+    } else {
+        std::cerr << "No se pudo escribir la traza en " << path << std::endl;
+    }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Benchmark sin ventana (EGL + FBO, sin VSync)
+    if (Headless::requested(argc, argv)) {
+        return Headless::run(argc, argv);
+    }
+    
     // Inicialización GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW\n";
@@ -53,6 +106,12 @@ int main() {
     glfwSetCursorPosCallback(window, mouseCallback);
     glfwSetScrollCallback(window, scrollCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetKeyCallback(window, keyCallback);
+    
+    if constexpr (Trace::COMPILED) {
+        Trace::setThreadName("Principal");
+        std::cout << "Traza: " << (Trace::enabled() ? "grabando" : "en pausa") << " (F8 alterna, F9 exporta)" << std::endl;
+    }
     
     // Inicializar GLAD
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -63,74 +122,302 @@ int main() {
     
     std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
     
-    // Inicializar componentes
-    Renderer renderer;
+    // Inicializar componentes: la GUI (widgets) en este hilo; el Renderer y
+    // el backend OpenGL de ImGui en el hilo de render, dueño del contexto
     GUI gui;
     Camera camera;
+    RenderThread renderThread;
     
-    if (!renderer.initialize(window)) {
+    gui.initialize(window);
+    if (!renderThread.start(window, gui)) {
         std::cerr << "Failed to initialize renderer\n";
+        gui.cleanup();
         glfwTerminate();
         return -1;
     }
     
-    gui.initialize(window);
+    // Crear modelo (compartido con el hilo de render; al regenerar se publica otro)
+    auto arcane = std::make_shared<Arcane>(36, 2);
+    
+    std::cout << "Arcane initialized with " << arcane->getNumNodes() << " nodes" << std::endl;
     
-    // Crear modelo
-    Arcane arcane(36, 2);
+    // Fases del perfilador medidas en este hilo (las de render las registra el hilo de render)
+    Profiler& profiler = Profiler::instance();
+    const uint32_t simulationPhase = profiler.phase("Simulación");
+    const uint32_t imguiPhase = profiler.phase("ImGui");
+    const uint32_t pathPhase = profiler.phase("Ruta");
+    const uint32_t layoutPhase = profiler.phase("Layout");
     
-    std::cout << "Arcane initialized with " << arcane.getNumNodes() << " nodes" << std::endl;
+    // ----- Estado de la escena publicado en cada snapshot -----
+    RenderSettings settings;
+    uint64_t frameNumber = 0;
+    uint64_t stateVersion = 0;          // Versiones únicas para los estados de resaltado
+    uint64_t pathVersion = 0, metricVersion = 0, focusVersion = 0;
+    std::shared_ptr<const DynamicArray<const Node*>> path;
+    std::shared_ptr<const DynamicArray<float>> metric;
+    std::shared_ptr<const Neighborhood> focus;
+    Octree nodeIndex(Renderer::NODE_RADIUS);    // Se sincroniza con la red al hacer picking
     
-    // Loop principal
+    // Layout de fuerzas: posiciones propias en este hilo; el de render las
+    // aplica a la red, así que desde el primer reset no se leen las de Arcane
+    ForceLayout layout(Renderer::NODE_RADIUS);
+    bool layoutReady = false;                   // reset() hecho con la red actual
+    uint64_t layoutVersion = 0;
+    std::shared_ptr<const DynamicArray<glm::vec3>> layoutPositions;
+    
+    // Loop principal (simulación y UI): consultas o regeneraciones lentas
+    // retrasan este hilo, no el render, que sigue con el último snapshot
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        // Fuera del scope del frame para que la traza no quede con un begin abierto
+        if constexpr (Trace::COMPILED) {
+            if (traceToggleRequested) {
+                Trace::setEnabled(!Trace::enabled());
+                std::cout << "Traza: " << (Trace::enabled() ? "grabando" : "en pausa") << std::endl;
+            }
+            if (traceDumpRequested) writeTrace();
+        }
+        traceToggleRequested = false;
+        traceDumpRequested = false;
         
-        // Input handling
-        camera.handleMouseMovement(mouseX, mouseY, mousePressed);
-        camera.handleScroll(scrollY);
-        scrollY = 0.0; // Reset scroll
+        MULTIVERSO_TRACE_SCOPE("frame", "Simulacion");
+        Profiler::Scope frameScope(simulationPhase);
+        auto frameStart = AllocCounter::snapshot();
+        {
+            MULTIVERSO_TRACE_SCOPE("frame", "Entrada");
+            glfwPollEvents();
+            
+            // Input handling
+            camera.handleMouseMovement(mouseX, mouseY, mousePressed);
+            camera.handleScroll(scrollY);
+            scrollY = 0.0; // Reset scroll
+        }
         
-        // Configurar matrices de vista y proyección
-        renderer.setViewMatrix(camera.getViewMatrix());
         int width, height;
         glfwGetFramebufferSize(window, &width, &height);
-        renderer.setProjectionMatrix(Renderer::calculateProjection(static_cast<float>(width)/height));
+        const glm::mat4 view = camera.getViewMatrix();
+        const glm::mat4 projection = Renderer::calculateProjection(static_cast<float>(width) / std::max(height, 1));
+        
+        // Picking: rayo del cursor por la inversa de view-projection (coordenadas de ventana, no de framebuffer).
+        // Con los botones sueltos se busca también en cada frame el nodo bajo el cursor (tooltip de distancias)
+        const bool buttonsUp = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_RELEASE &&
+                               glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_RELEASE;
+        int hoveredNode = -1;
+        if ((pickRequested || buttonsUp) && !ImGui::GetIO().WantCaptureMouse) {
+            int windowWidth, windowHeight;
+            glfwGetWindowSize(window, &windowWidth, &windowHeight);
+            const float x = 2.0f * static_cast<float>(mouseX) / std::max(windowWidth, 1) - 1.0f;
+            const float y = 1.0f - 2.0f * static_cast<float>(mouseY) / std::max(windowHeight, 1);
+            const glm::mat4 inverse = glm::inverse(projection * view);
+            const glm::vec4 nearPoint = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+            const glm::vec4 farPoint = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+            const glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+            
+            // Con el layout, el índice de sus posiciones (las de la red las escribe el render)
+            const Octree* index = &layout.index();
+            if (!layoutReady) {
+                nodeIndex.update(*arcane);
+                index = &nodeIndex;
+            }
+            const Octree::Hit hit = index->pick(origin, glm::vec3(farPoint) / farPoint.w - origin);
+            if (hit.id != Octree::NONE) {
+                hoveredNode = static_cast<int>(hit.id);
+                if (pickRequested) {
+                    const int slot = (pickButton == GLFW_MOUSE_BUTTON_RIGHT) ? 1 : 0;
+                    gui.setSelectedNode(slot, hoveredNode);
+                    std::cout << (slot == 0 ? "Origen: " : "Destino: ") << "nodo " << hit.id << " (nivel "
+                              << arcane->getNodes()[hit.id]._level << ")" << std::endl;
+                }
+            }
+        }
+        gui.setHoveredNode(hoveredNode);
+        pickRequested = false;
         
         // UI updates
         gui.beginFrame();
-        gui.render(arcane);
+        {
+            Profiler::Scope scope(imguiPhase);
+            MULTIVERSO_TRACE_SCOPE("frame", "ImGui");
+            gui.render(*arcane);
+        }
+        profiler.setEnabled(gui.isProfilerEnabled());
         
-        // Regenerar red si se solicita
+        // Regenerar red si se solicita (el render sigue dibujando la anterior)
         if (auto params = gui.getRegenerationParams()) {
             auto [nodeCount, initialNodes] = *params;
             std::cout << "Reconstruyendo con " << nodeCount << " nodos, " << initialNodes << " y nodos iniciales" << std::endl;
-            arcane = Arcane(nodeCount, initialNodes);
+            MULTIVERSO_TRACE_SCOPE("generacion", "Arcane");
+            arcane = std::make_shared<Arcane>(nodeCount, initialNodes);
+            nodeIndex.clear();
+            layout.clear();
+            layoutReady = false;
+            
+            // Los estados (y los índices de picking y del layout) eran de la red anterior
+            path = nullptr;
+            metric = nullptr;
+            focus = nullptr;
+            layoutPositions = nullptr;
+            pathVersion = metricVersion = focusVersion = layoutVersion = ++stateVersion;
+        }
+        
+        // Ajustes del renderer; el hilo de render aplica los que cambian
+        settings.arrowMode = gui.isGpuArrowsEnabled() ? ArrowRenderMode::Endpoints : ArrowRenderMode::Matrices;
+        settings.sphereMode = gui.isImpostorsEnabled() ? SphereRenderMode::Impostor : SphereRenderMode::Mesh;
+        settings.streaming = gui.isStreamingEnabled();
+        settings.culling = gui.isCullingEnabled();
+        settings.levelOfDetail = gui.isLevelOfDetailEnabled();
+        settings.gpuCulling = gui.isGpuCullingEnabled();
+        settings.paletteColors = gui.isPaletteColorsEnabled();
+        settings.edgeBundling = gui.isEdgeBundlingEnabled();
+        
+        // Layout de fuerzas: una rebanada por frame; las posiciones se publican
+        // al cerrar cada iteración y, al desactivarlo, vuelven las de la red
+        bool layoutMoved = false;
+        if (gui.isForceLayoutEnabled()) {
+            Profiler::Scope scope(layoutPhase);
+            if (!layoutReady) {
+                layout.reset(*arcane);          // Nadie ha movido aún los nodos de esta red
+                layoutReady = true;
+            }
+            layoutMoved = layout.run() > 0;
+            if (layoutMoved && layout.converged()) {
+                std::cout << "Layout convergido en " << layout.iteration() << " iteraciones" << std::endl;
+            }
+        } else if (layoutReady && layout.iteration() > 0) {
+            layout.restore();
+            layoutMoved = true;
+        }
+        if (layoutMoved) {
+            DynamicArray<glm::vec3> positions;
+            positions.assign(layout.size(), glm::vec3(0.0f));
+            std::copy(layout.positions(), layout.positions() + layout.size(), positions.data());
+            layoutPositions = std::make_shared<const DynamicArray<glm::vec3>>(std::move(positions));
+            layoutVersion = ++stateVersion;
         }
         
         //Buscar ruta si se solicita
         if (gui.isPathFindingRequested()) {
             auto [node1, node2] = gui.getSelectedNodes();
             std::cout << "Buscando camino entre " << node1 << " y " << node2 << std::endl;
-            auto path = arcane.findPath(node1, node2);
-            if (!path.empty()) {
-                std::cout << "Camino encontrado con " << path.size() << " 5 nodos" << std::endl;
+            Profiler::Scope scope(pathPhase);
+            auto found = arcane->findPath(node1, node2, gui.isALTEnabled() ? PathMode::ALT : PathMode::BFS);
+            if (!found.empty()) {
+                std::cout << "Camino encontrado con " << found.size() << " 5 nodos" << std::endl;
             } else {
                 std::cout << "No se encontro camino" << std::endl;
             }
-            arcane.highlightPath(path);
+            path = std::make_shared<const DynamicArray<const Node*>>(std::move(found));
+            pathVersion = ++stateVersion;
+        }
+        
+        // Colorear por centralidad si se solicita
+        if (auto request = gui.getMetricRequest()) {
+            auto [kind, samples] = *request;
+            if (kind == 0) {
+                metric = nullptr;
+            } else {
+                auto start = std::chrono::steady_clock::now();
+                auto values = (kind == 1) ? Centrality::betweenness(*arcane, samples)
+                                          : Centrality::closeness(*arcane, samples);
+                auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+                
+                std::cout << (kind == 1 ? "Intermediacion" : "Cercania") << " calculada en "
+                          << elapsed.count() << " ms. Hubs:";
+                for (uint32_t id : Centrality::topNodes(values, 5)) {
+                    std::cout << " " << id << " (" << values[id] << ")";
+                }
+                std::cout << std::endl;
+                
+                metric = std::make_shared<const DynamicArray<float>>(std::move(values));
+            }
+            metricVersion = ++stateVersion;
         }
         
-        // Render
-        renderer.render(arcane);
+        // Vecindad a k saltos del nodo origen
+        if (auto request = gui.getNeighborhoodRequest()) {
+            auto [hops, direction] = *request;
+            auto [node1, node2] = gui.getSelectedNodes();
+            auto hood = arcane->neighborhood(node1, hops, static_cast<NeighborDirection>(direction));
+            std::cout << "Vecindad de " << node1 << " a " << hops << " saltos: " << hood.nodes.size()
+                      << " nodos, " << hood.arrows.size() << " flechas" << std::endl;
+            focus = std::make_shared<const Neighborhood>(std::move(hood));
+            focusVersion = ++stateVersion;
+        }
+        if (gui.isFocusClearRequested()) {
+            focus = nullptr;
+            focusVersion = ++stateVersion;
+        }
+        
+        // ----- Snapshot del frame -----
+        const ImDrawData* drawData = nullptr;
+        {
+            Profiler::Scope scope(imguiPhase);
+            MULTIVERSO_TRACE_SCOPE("frame", "ImGui");
+            drawData = gui.endFrame();
+        }
+        {
+            MULTIVERSO_TRACE_SCOPE("frame", "Snapshot");
+            FrameSnapshot& snapshot = renderThread.snapshot();
+            snapshot.frame = ++frameNumber;
+            snapshot.view = view;
+            snapshot.projection = projection;
+            snapshot.width = width;
+            snapshot.height = height;
+            snapshot.settings = settings;
+            snapshot.arcane = arcane;
+            snapshot.pathVersion = pathVersion;
+            snapshot.path = path;
+            snapshot.metricVersion = metricVersion;
+            snapshot.metric = metric;
+            snapshot.focusVersion = focusVersion;
+            snapshot.focus = focus;
+            snapshot.layoutVersion = layoutVersion;
+            snapshot.layout = layoutPositions;
+            snapshot.ui.capture(drawData);
+            renderThread.publish();
+        }
         
-        gui.endFrame();
-        glfwSwapBuffers(window);
+        // Se muestran en el frame siguiente (lo último que dibujó el hilo de render)
+        const RenderStats& rendered = renderThread.stats();
+        GUI::FrameStats stats;
+        stats.allocations = AllocCounter::since(frameStart).allocations;
+        stats.uploadedBytes = rendered.uploadedBytes;
+        stats.culling = rendered.culling;
+        stats.cullMilliseconds = rendered.cull.milliseconds;
+        stats.visibleNodes = rendered.cull.visibleNodes;
+        stats.totalNodes = rendered.cull.totalNodes;
+        stats.visibleArrows = rendered.cull.visibleArrows;
+        stats.totalArrows = rendered.cull.totalArrows;
+        stats.levelOfDetail = rendered.levelOfDetail;
+        stats.nodeLevels = rendered.draw.nodeLevels;
+        stats.arrowLevels = rendered.draw.arrowLevels;
+        stats.bundles = rendered.draw.bundles;
+        stats.bundledArrows = rendered.draw.bundledArrows;
+        stats.layoutIteration = layout.iteration();
+        stats.layoutTemperature = layout.temperature();
+        stats.layoutConverged = layout.converged();
+        stats.triangles = rendered.draw.triangles;
+        stats.drawCalls = rendered.draw.drawCalls;
+        stats.drawnNodes = 0;
+        stats.drawnArrows = 0;
+        for (uint32_t level = 0; level < rendered.draw.nodeLevels.size(); ++level) {
+            stats.drawnNodes += rendered.draw.nodeLevels[level];
+            stats.drawnArrows += rendered.draw.arrowLevels[level];
+        }
+        gui.setFrameStats(stats);
+        
+        // Como mucho un frame por delante del render
+        renderThread.waitForPresent();
     }
     
-    // Cleanup
-    renderer.cleanup();
+    // Lo grabado y no exportado se guarda al salir
+    if constexpr (Trace::COMPILED) {
+        if (Trace::eventCount() > 0) writeTrace();
+    }
+    
+    // Cleanup: el hilo de render libera sus recursos GL antes de terminar
+    renderThread.stop();
     gui.cleanup();
     glfwTerminate();
     
     return 0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,20 @@
 #include "GUI.hpp"
+#include "core/Arcane.hpp"
+#include "utils/Profiler.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
+namespace {
+    constexpr float COLUMN_X = 20.0f;
+    constexpr float COLUMN_TOP = 20.0f;
+    constexpr float WINDOW_SPACING = 10.0f;
+}
+
 void GUI::initialize(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -11,26 +22,44 @@ void GUI::initialize(GLFWwindow* window) {
     ImGui::StyleColorsDark();
     
     ImGui_ImplGlfw_InitForOpenGL(window, true);
+}
+
+void GUI::initializeRenderer() {
     ImGui_ImplOpenGL3_Init("#version 330");
+    
+    // La textura de fuentes construye el atlas que ImGui::NewFrame exige en el hilo de UI
+    ImGui_ImplOpenGL3_CreateDeviceObjects();
 }
 
 void GUI::beginFrame() {
-    ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 }
 
-void GUI::render(Arcane& arcane) {
+void GUI::render(const Arcane& arcane) {
+    columnBottom = COLUMN_TOP;
     renderNetworkControls();
-    renderPathFindingControls();
+    renderPathFindingControls(arcane);
+    renderAnalysisControls();
+    renderProfiler();
+    renderHoverTooltip(arcane);
+}
+
+void GUI::beginColumnWindow(const char* name, float width) {
+    // Se recoloca cada frame: la altura de la anterior cambia con sus estadísticas
+    ImGui::SetNextWindowPos(ImVec2(COLUMN_X, columnBottom), ImGuiCond_Always);
+    ImGui::SetNextWindowSizeConstraints(ImVec2(width, 0.0f), ImVec2(width, FLT_MAX));
+    ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize |
+                                ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_AlwaysAutoResize);
+}
+
+void GUI::endColumnWindow() {
+    columnBottom = ImGui::GetWindowPos().y + ImGui::GetWindowSize().y + WINDOW_SPACING;
+    ImGui::End();
 }
 
 void GUI::renderNetworkControls() {
-    ImGui::SetNextWindowPos(ImVec2(20, 20), ImGuiCond_Once);
-    ImGui::SetNextWindowSize(ImVec2(350, 120), ImGuiCond_Once);
-    
-    ImGui::Begin("Control de Nodos", nullptr,
-                 ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+    beginColumnWindow("Control de Nodos", 400.0f);
     
     ImGui::PushItemWidth(100);
     if (ImGui::InputInt("Número de nodos", &newNodeCount)) {
@@ -50,16 +79,58 @@ void GUI::renderNetworkControls() {
     } else {
         regenerateRequested = false;
     }
+    ImGui::SameLine();
+    ImGui::Checkbox("Flechas en GPU", &gpuArrows);
+    ImGui::SameLine();
+    ImGui::Checkbox("Streaming", &streamingBuffers);
+    ImGui::Checkbox("Culling", &frustumCulling);
+    ImGui::SameLine();
+    ImGui::Checkbox("Impostores", &sphereImpostors);
+    ImGui::SameLine();
+    ImGui::Checkbox("LOD", &levelOfDetail);
+    ImGui::SameLine();
+    ImGui::Checkbox("En GPU", &gpuCulling);
+    // Fila nueva: las seis casillas no caben en el ancho de la ventana
+    ImGui::Checkbox("Paleta", &paletteColors);
+    ImGui::SameLine();
+    ImGui::Checkbox("Haces", &edgeBundling);
+    ImGui::SameLine();
+    ImGui::Checkbox("Layout de fuerzas", &forceLayout);
     
-    ImGui::End();
+    // En estado estable ambos deben ser 0
+    ImGui::Text("Frame: %llu asignaciones, %llu bytes subidos",
+                static_cast<unsigned long long>(frameStats.allocations),
+                static_cast<unsigned long long>(frameStats.uploadedBytes));
+    if (frameStats.culling) {
+        ImGui::Text("Visibles: %u/%u nodos, %u/%u flechas (%.2f ms)",
+                    frameStats.visibleNodes, frameStats.totalNodes,
+                    frameStats.visibleArrows, frameStats.totalArrows,
+                    frameStats.cullMilliseconds);
+    } else {
+        ImGui::TextDisabled("Culling desactivado");
+    }
+    if (frameStats.levelOfDetail) {
+        // Una línea por tipo: con 5 o más cifras por nivel no caben en una
+        ImGui::Text("LOD nodos: %u/%u/%u",
+                    frameStats.nodeLevels[0], frameStats.nodeLevels[1], frameStats.nodeLevels[2]);
+        ImGui::Text("LOD flechas: %u/%u/%u + %u líneas",
+                    frameStats.arrowLevels[0], frameStats.arrowLevels[1], frameStats.arrowLevels[2],
+                    frameStats.arrowLevels[3]);
+    }
+    if (edgeBundling) {
+        ImGui::Text("Haces: %u (%u flechas agrupadas)", frameStats.bundles, frameStats.bundledArrows);
+    }
+    ImGui::Text("Triángulos: %.2f M", static_cast<double>(frameStats.triangles) / 1e6);
+    if (forceLayout) {
+        ImGui::Text("Layout: iteración %u, temperatura %.3f%s", frameStats.layoutIteration,
+                    frameStats.layoutTemperature, frameStats.layoutConverged ? " (convergido)" : "");
+    }
+    
+    endColumnWindow();
 }
 
-void GUI::renderPathFindingControls() {
-    ImGui::SetNextWindowPos(ImVec2(20, 150), ImGuiCond_Once);
-    ImGui::SetNextWindowSize(ImVec2(200, 120), ImGuiCond_Once);
-    
-    ImGui::Begin("Búsqueda de ruta", nullptr,
-                 ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+void GUI::renderPathFindingControls(const Arcane& arcane) {
+    beginColumnWindow("Búsqueda de ruta", 260.0f);
     
     ImGui::PushItemWidth(100);
     if (ImGui::InputInt("Nodo origen", &selectedNode1)) {
@@ -80,17 +151,169 @@ void GUI::renderPathFindingControls() {
     } else {
         pathFindingRequested = false;
     }
+    ImGui::SameLine();
+    ImGui::Checkbox("ALT", &useALT);
+    ImGui::TextDisabled("Clic: origen, clic derecho: destino");
+    
+    renderDistanceBounds(arcane, selectedNode1, selectedNode2);
+    
+    const auto& cache = arcane.getPathCacheStats();
+    ImGui::Text("Caché: %llu aciertos, %llu árbol, %llu fallos",
+                static_cast<unsigned long long>(cache.hits),
+                static_cast<unsigned long long>(cache.treeHits),
+                static_cast<unsigned long long>(cache.misses));
+    
+    endColumnWindow();
+}
+
+void GUI::renderDistanceBounds(const Arcane& arcane, int from, int to) {
+    // Cotas del oráculo de landmarks, O(K) por consulta
+    auto bounds = arcane.distanceBounds(from, to);
+    if (arcane.getLandmarks().empty()) {
+        ImGui::TextDisabled("Distancia: sin landmarks");
+    } else if (bounds.unreachable()) {
+        ImGui::Text("Distancia: inalcanzable");
+    } else if (bounds.upper == LandmarkOracle::UNREACHABLE) {
+        ImGui::Text("Distancia: >= %u saltos", bounds.lower);
+    } else if (bounds.exact()) {
+        ImGui::Text("Distancia: %u saltos", bounds.lower);
+    } else {
+        ImGui::Text("Distancia: [%u, %u] saltos", bounds.lower, bounds.upper);
+    }
+}
+
+void GUI::renderHoverTooltip(const Arcane& arcane) {
+    if (hoveredNode < 0 || static_cast<uint32_t>(hoveredNode) >= arcane.getNumNodes()) return;
+    if (ImGui::GetIO().WantCaptureMouse) return;
+    
+    // El nivel es topología: se lee sin tocar las posiciones que escribe el render
+    ImGui::BeginTooltip();
+    ImGui::Text("Nodo %d (nivel %u)", hoveredNode, arcane.getNodes()[hoveredNode]._level);
+    ImGui::TextDisabled("Desde el origen %d", selectedNode1);
+    renderDistanceBounds(arcane, selectedNode1, hoveredNode);
+    ImGui::EndTooltip();
+}
+
+void GUI::renderAnalysisControls() {
+    beginColumnWindow("Análisis", 260.0f);
+    
+    const char* metricas[] = { "Nivel", "Intermediación", "Cercanía" };
+    ImGui::PushItemWidth(140);
+    ImGui::Combo("Métrica", &selectedMetric, metricas, IM_ARRAYSIZE(metricas));
+    ImGui::PopItemWidth();
+    
+    ImGui::PushItemWidth(100);
+    if (ImGui::InputInt("Pivotes", &metricSamples)) {
+        if (metricSamples < 0) metricSamples = 0;
+    }
+    ImGui::PopItemWidth();
+    ImGui::TextDisabled("0 pivotes = cálculo exacto");
+    
+    if (ImGui::Button("Colorear")) {
+        metricRequested = true;
+    } else {
+        metricRequested = false;
+    }
+    
+    // ----- Vecindad a k saltos del nodo origen -----
+    ImGui::Separator();
+    ImGui::PushItemWidth(100);
+    if (ImGui::InputInt("Saltos", &neighborhoodHops)) {
+        if (neighborhoodHops < 0) neighborhoodHops = 0;
+    }
+    ImGui::PopItemWidth();
+    
+    const char* direcciones[] = { "Salida", "Entrada", "Ambas" };
+    ImGui::PushItemWidth(140);
+    ImGui::Combo("Dirección", &neighborhoodDirection, direcciones, IM_ARRAYSIZE(direcciones));
+    ImGui::PopItemWidth();
+    
+    neighborhoodRequested = ImGui::Button("Mostrar vecindad");
+    ImGui::SameLine();
+    focusClearRequested = ImGui::Button("Limpiar");
+    
+    endColumnWindow();
+}
+
+void GUI::renderProfiler() {
+    ImGui::SetNextWindowPos(ImVec2(440, 20), ImGuiCond_Once);
+    ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_Once);
+    
+    ImGui::Begin("Perfil", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::Checkbox("Activar", &profilerEnabled);
+    
+    const Profiler& profiler = Profiler::instance();
+    auto lock = profiler.lock();        // El hilo de render cierra frames del historial
+    if (!profiler.enabled()) {
+        ImGui::TextDisabled("Desactivado: sin consultas de GPU ni lecturas de reloj");
+        ImGui::End();
+        return;
+    }
+    
+    ImGui::Text("Dibujos: %u, instancias: %u nodos, %u flechas",
+                frameStats.drawCalls, frameStats.drawnNodes, frameStats.drawnArrows);
+    ImGui::TextDisabled("ms por frame: último (p50 / p95 / p99), %u frames", profiler.frames());
+    
+    // Una gráfica por fase con el historial circular
+    char overlay[96];
+    for (uint32_t phase = 0; phase < profiler.phaseCount(); ++phase) {
+        std::snprintf(overlay, sizeof(overlay), "%.2f (%.2f / %.2f / %.2f)",
+                      profiler.last(phase), profiler.percentile(phase, 0.5f),
+                      profiler.percentile(phase, 0.95f), profiler.percentile(phase, 0.99f));
+        ImGui::PlotLines(profiler.name(phase), profiler.history(phase), static_cast<int>(profiler.frames()),
+                         static_cast<int>(profiler.historyOffset()), overlay, 0.0f, FLT_MAX, ImVec2(260, 36));
+    }
     
     ImGui::End();
 }
 
-void GUI::endFrame() {
+const ImDrawData* GUI::endFrame() {
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    return ImGui::GetDrawData();
 }
 
-void GUI::cleanup() {
+namespace {
+    // resize conserva la capacidad (el operador = de ImVector la libera)
+    template <typename T>
+    void copyVector(ImVector<T>& dst, const ImVector<T>& src) {
+        dst.resize(src.Size);
+        if (src.Size > 0) std::memcpy(dst.Data, src.Data, src.size_in_bytes());
+    }
+}
+
+void GUI::DrawDataCopy::capture(const ImDrawData* source) {
+    data.Clear();
+    if (!source || !source->Valid) return;
+    
+    while (lists.size() < static_cast<size_t>(source->CmdListsCount)) {
+        lists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+    }
+    for (int i = 0; i < source->CmdListsCount; ++i) {
+        const ImDrawList& src = *source->CmdLists[i];
+        ImDrawList& dst = *lists[i];
+        copyVector(dst.CmdBuffer, src.CmdBuffer);
+        copyVector(dst.IdxBuffer, src.IdxBuffer);
+        copyVector(dst.VtxBuffer, src.VtxBuffer);
+        dst.Flags = src.Flags;
+        data.AddDrawList(&dst);
+    }
+    data.Valid = true;
+    data.DisplayPos = source->DisplayPos;
+    data.DisplaySize = source->DisplaySize;
+    data.FramebufferScale = source->FramebufferScale;
+}
+
+void GUI::renderDrawData(DrawDataCopy& drawData) {
+    if (drawData.valid()) {
+        ImGui_ImplOpenGL3_RenderDrawData(&drawData.data);
+    }
+}
+
+void GUI::cleanupRenderer() {
     ImGui_ImplOpenGL3_Shutdown();
+}
+
+void GUI::cleanup() {
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 }
\ No newline at end of file
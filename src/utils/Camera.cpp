@@ -32,6 +32,12 @@ void Camera::handleScroll(double yoffset) noexcept {
     if (radius > 50.0f) radius = 50.0f;
 }
 
+void Camera::setOrbit(float yawDegrees, float pitchDegrees, float distance) noexcept {
+    yaw = yawDegrees;
+    pitch = glm::clamp(pitchDegrees, -89.0f, 89.0f);
+    radius = glm::clamp(distance, 2.0f, 50.0f);
+}
+
 glm::vec3 Camera::calculateCameraPosition() const noexcept {
     float camX = radius * cosf(glm::radians(yaw)) * cosf(glm::radians(pitch));
     float camY = radius * sinf(glm::radians(pitch));
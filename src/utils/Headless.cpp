@@ -0,0 +1,419 @@
+#include "utils/Headless.hpp"
+#include "graphics/Renderer.hpp"
+#include "core/Arcane.hpp"
+#include "core/ForceLayout.hpp"
+#include "utils/Camera.hpp"
+#include "utils/PngWriter.hpp"
+#include "utils/Profiler.hpp"
+
+#ifdef MULTIVERSO_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // Muestras por frame medido (el warmup no se guarda)
+    struct FrameSample {
+        double cpuMilliseconds = 0.0;       // Envío de comandos: render() hasta que devuelve
+        double frameMilliseconds = 0.0;     // render() + glFinish
+        double gpuMilliseconds = 0.0;       // Consultas TIME_ELAPSED de flechas y esferas
+        uint32_t drawCalls = 0;
+        uint64_t triangles = 0;
+    };
+
+    bool parseUint(const char* text, uint32_t& value) {
+        char* end = nullptr;
+        const unsigned long parsed = std::strtoul(text, &end, 10);
+        if (!end || *end != '\0' || end == text) return false;
+        value = static_cast<uint32_t>(parsed);
+        return true;
+    }
+
+    bool parseOptions(int argc, char** argv, Headless::Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--headless") continue;
+            if (arg == "--culling") { options.culling = true; continue; }
+            if (arg == "--lod") { options.levelOfDetail = true; continue; }
+            if (arg == "--gpu-culling") { options.gpuCulling = true; continue; }
+            if (arg == "--palette") { options.paletteColors = true; continue; }
+            if (arg == "--mesh") { options.sphereMesh = true; continue; }
+            if (arg == "--gpu-arrows") { options.gpuArrows = true; continue; }
+            if (arg == "--bundles") { options.edgeBundling = true; continue; }
+            if (arg == "--layout") { options.forceLayout = true; continue; }
+
+            static constexpr std::string_view VALUE_OPTIONS[] = {
+                "--nodes", "--initial", "--frames", "--warmup", "--png-every", "--csv", "--png", "--size"
+            };
+            if (std::find(std::begin(VALUE_OPTIONS), std::end(VALUE_OPTIONS), arg) == std::end(VALUE_OPTIONS)) {
+                std::cerr << "Opción desconocida: " << arg << std::endl;
+                return false;
+            }
+            if (!hasValue) {
+                std::cerr << "Falta el valor de " << arg << std::endl;
+                return false;
+            }
+            const char* value = argv[++i];
+            bool ok = true;
+            if (arg == "--nodes") ok = parseUint(value, options.nodes);
+            else if (arg == "--initial") ok = parseUint(value, options.initialNodes);
+            else if (arg == "--frames") ok = parseUint(value, options.frames);
+            else if (arg == "--warmup") ok = parseUint(value, options.warmup);
+            else if (arg == "--png-every") ok = parseUint(value, options.pngEvery);
+            else if (arg == "--csv") options.csvPath = value;
+            else if (arg == "--png") options.pngDirectory = value;
+            else {
+                ok = std::sscanf(value, "%ux%u", &options.width, &options.height) == 2 &&
+                     options.width > 0 && options.height > 0;
+            }
+            if (!ok) {
+                std::cerr << "Valor inválido para " << arg << ": " << value << std::endl;
+                return false;
+            }
+        }
+
+        // Mismos mínimos que la GUI
+        options.nodes = std::max(options.nodes, 36u);
+        options.initialNodes = std::clamp(options.initialNodes, 2u, options.nodes);
+        options.frames = std::max(options.frames, 1u);
+        return true;
+    }
+
+    void printUsage() {
+        std::cerr << "Uso: Multiverso --headless [--nodes N] [--initial N] [--frames N] [--warmup N]\n"
+                     "                [--size WxH] [--csv archivo] [--png directorio] [--png-every N]\n"
+                     "                [--culling] [--lod] [--gpu-culling] [--palette] [--mesh] [--gpu-arrows]\n"
+                     "                [--bundles] [--layout]" << std::endl;
+    }
+
+    // Percentil por rango más cercano sobre una copia ordenada
+    double percentile(std::vector<double> values, double p) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        const size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+        return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+    }
+
+    void printSummary(const char* label, const std::vector<FrameSample>& samples,
+                      double FrameSample::* field) {
+        std::vector<double> values;
+        values.reserve(samples.size());
+        double sum = 0.0;
+        for (const auto& sample : samples) {
+            values.push_back(sample.*field);
+            sum += sample.*field;
+        }
+        const double mean = values.empty() ? 0.0 : sum / values.size();
+        std::printf("  %-6s media %7.3f  p50 %7.3f  p95 %7.3f  p99 %7.3f  máx %7.3f ms\n", label, mean,
+                    percentile(values, 0.50), percentile(values, 0.95), percentile(values, 0.99),
+                    percentile(values, 1.0));
+    }
+
+#ifdef MULTIVERSO_HEADLESS
+    // Contexto OpenGL 3.3 core sin superficie: EGL_MESA_platform_surfaceless
+    // si existe (sin servidor gráfico), si no el display por defecto de EGL
+    class EglContext {
+    public:
+        ~EglContext() { destroy(); }
+
+        bool create() {
+            auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            if (getPlatformDisplay) {
+                display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+            if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+            EGLint major = 0, minor = 0;
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+                std::cerr << "EGL: no se pudo inicializar el display" << std::endl;
+                return false;
+            }
+            initialized = true;
+
+            const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+            if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context")) {
+                std::cerr << "EGL: falta EGL_KHR_surfaceless_context" << std::endl;
+                return false;
+            }
+            if (!eglBindAPI(EGL_OPENGL_API)) {
+                std::cerr << "EGL: OpenGL de escritorio no disponible" << std::endl;
+                return false;
+            }
+
+            // Sin superficie la configuración solo importa por el API; sin
+            // ninguna compatible se usa EGL_KHR_no_config_context
+            const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+            EGLConfig config = EGL_NO_CONFIG_KHR;
+            EGLint configCount = 0;
+            if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+                config = EGL_NO_CONFIG_KHR;
+            }
+
+            const EGLint contextAttributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, 3,
+                EGL_CONTEXT_MINOR_VERSION, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+            };
+            context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+            if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+                std::cerr << "EGL: no se pudo crear un contexto OpenGL 3.3 core" << std::endl;
+                return false;
+            }
+
+            std::cout << "EGL " << major << "." << minor << " (" << eglQueryString(display, EGL_VENDOR) << ")" << std::endl;
+            return true;
+        }
+
+        void destroy() noexcept {
+            if (context != EGL_NO_CONTEXT) {
+                eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                eglDestroyContext(display, context);
+                context = EGL_NO_CONTEXT;
+            }
+            if (initialized) {
+                eglTerminate(display);
+                initialized = false;
+            }
+        }
+
+        static void* procAddress(const char* name) {
+            return reinterpret_cast<void*>(eglGetProcAddress(name));
+        }
+
+    private:
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+        bool initialized = false;
+    };
+#endif
+
+    // Destino de render sin ventana: color RGBA8 y profundidad de 24 bits
+    struct Framebuffer {
+        GLuint fbo = 0;
+        GLuint color = 0;
+        GLuint depth = 0;
+
+        bool create(uint32_t width, uint32_t height) {
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+            glGenRenderbuffers(1, &color);
+            glBindRenderbuffer(GL_RENDERBUFFER, color);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+            glGenRenderbuffers(1, &depth);
+            glBindRenderbuffer(GL_RENDERBUFFER, depth);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+            glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+            return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        void destroy() noexcept {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            if (depth) glDeleteRenderbuffers(1, &depth);
+            if (color) glDeleteRenderbuffers(1, &color);
+            if (fbo) glDeleteFramebuffers(1, &fbo);
+            fbo = color = depth = 0;
+        }
+    };
+
+    // Una vuelta completa de yaw con oscilación de altura y distancia: pasa
+    // por vistas cercanas (LOD alto, mucho culling) y lejanas (toda la red)
+    void scriptedCamera(Camera& camera, uint32_t frame, uint32_t frames) {
+        const float t = static_cast<float>(frame) / static_cast<float>(frames);
+        const float angle = 6.2831853f * t;
+        camera.setOrbit(90.0f + 360.0f * t, 30.0f * std::sin(2.0f * angle), 18.0f - 12.0f * std::cos(angle));
+    }
+
+    int runFrames(const Headless::Options& options) {
+        Renderer renderer;
+        if (!renderer.initialize(nullptr)) {     // Sin ventana: el renderer no la usa para dibujar
+            std::cerr << "Failed to initialize renderer\n";
+            return 1;
+        }
+
+        Framebuffer target;
+        if (!target.create(options.width, options.height)) {
+            std::cerr << "Framebuffer incompleto (" << options.width << "x" << options.height << ")" << std::endl;
+            target.destroy();
+            renderer.cleanup();
+            return 1;
+        }
+
+        // Configuración fija para todo el recorrido
+        const ArrowRenderMode arrowMode = options.gpuArrows ? ArrowRenderMode::Endpoints : ArrowRenderMode::Matrices;
+        renderer.setArrowMode(arrowMode);
+        renderer.setSphereMode(options.sphereMesh ? SphereRenderMode::Mesh : SphereRenderMode::Impostor);
+        renderer.setCulling(options.culling);
+        renderer.setLevelOfDetail(options.levelOfDetail);
+        renderer.setGpuCulling(options.gpuCulling);
+        renderer.setPaletteColors(options.paletteColors);
+        renderer.setEdgeBundling(options.edgeBundling);
+        if (options.gpuCulling && !renderer.isGpuCulling()) {
+            std::cerr << "Culling en GPU no disponible (requiere GL 4.3); se usa la CPU" << std::endl;
+        }
+        renderer.setProjectionMatrix(Renderer::calculateProjection(
+            static_cast<float>(options.width) / static_cast<float>(options.height)));
+
+        const auto generationStart = std::chrono::steady_clock::now();
+        Arcane arcane(options.nodes, options.initialNodes);
+        arcane.setArrowTransformsEnabled(arrowMode == ArrowRenderMode::Matrices);
+        std::cout << "Red: " << arcane.getNumNodes() << " nodos, " << arcane.getNumArrows() << " flechas ("
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - generationStart).count()
+                  << " ms)" << std::endl;
+
+        // El layout avanza su rebanada antes de cada frame, fuera del tiempo de render
+        ForceLayout layout;
+        if (options.forceLayout) layout.reset(arcane);
+        uint32_t movedNodes = 0;
+
+        // Los tiempos de GPU salen del perfilador (fases registradas por el Renderer)
+        Profiler& profiler = Profiler::instance();
+        profiler.setEnabled(true);
+        const uint32_t gpuArrowsPhase = profiler.phase("Flechas (GPU)");
+        const uint32_t gpuSpheresPhase = profiler.phase("Esferas (GPU)");
+
+        if (!options.pngDirectory.empty()) {
+            std::error_code error;
+            std::filesystem::create_directories(options.pngDirectory, error);
+        }
+        std::vector<uint8_t> pixels;
+        uint32_t pngCount = 0;
+
+        Camera camera;
+        std::vector<FrameSample> samples(options.frames);
+
+        // Los resultados de GpuTimer llegan un frame después: se dibuja uno
+        // más, fuera de las estadísticas, para recoger los del último
+        const uint32_t total = options.warmup + options.frames + 1;
+        for (uint32_t frame = 0; frame < total; ++frame) {
+            const bool measured = frame >= options.warmup && frame < options.warmup + options.frames;
+            const uint32_t index = frame - options.warmup;
+            scriptedCamera(camera, measured ? index : 0, options.frames);
+            renderer.setViewMatrix(camera.getViewMatrix());
+            if (options.forceLayout && layout.run() > 0) {
+                movedNodes += arcane.moveNodes(layout.positions());
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            renderer.render(arcane);
+            const auto submitted = std::chrono::steady_clock::now();
+            glFinish();
+            const auto finished = std::chrono::steady_clock::now();
+            profiler.endFrame();
+
+            // GPU del frame anterior
+            if (frame > options.warmup && frame <= options.warmup + options.frames) {
+                samples[index - 1].gpuMilliseconds = profiler.last(gpuArrowsPhase) + profiler.last(gpuSpheresPhase);
+            }
+            if (!measured) continue;
+
+            FrameSample& sample = samples[index];
+            sample.cpuMilliseconds = std::chrono::duration<double, std::milli>(submitted - start).count();
+            sample.frameMilliseconds = std::chrono::duration<double, std::milli>(finished - start).count();
+            sample.drawCalls = renderer.getDrawStats().drawCalls;
+            sample.triangles = renderer.getDrawStats().triangles;
+
+            const bool dump = !options.pngDirectory.empty() &&
+                              (options.pngEvery == 0 ? index == 0 : index % options.pngEvery == 0);
+            if (dump) {
+                pixels.resize(static_cast<size_t>(options.width) * options.height * 4);
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%05u.png", index);
+                const auto path = std::filesystem::path(options.pngDirectory) / name;
+                if (PngWriter::write(path.string(), options.width, options.height, pixels.data(), true)) {
+                    ++pngCount;
+                } else {
+                    std::cerr << "No se pudo escribir " << path.string() << std::endl;
+                }
+            }
+        }
+
+        profiler.setEnabled(false);
+        target.destroy();
+        renderer.cleanup();
+
+        std::cout << options.frames << " frames de " << options.width << "x" << options.height
+                  << " (" << options.warmup << " de calentamiento)" << std::endl;
+        printSummary("CPU", samples, &FrameSample::cpuMilliseconds);
+        printSummary("Frame", samples, &FrameSample::frameMilliseconds);
+        printSummary("GPU", samples, &FrameSample::gpuMilliseconds);
+        if (options.forceLayout) {
+            std::cout << "Layout: " << layout.iteration() << " iteraciones, temperatura " << layout.temperature()
+                      << (layout.converged() ? " (convergido)" : "") << ", " << movedNodes << " nodos movidos" << std::endl;
+        }
+        if (pngCount > 0) {
+            std::cout << pngCount << " PNG en " << options.pngDirectory << std::endl;
+        }
+
+        if (!options.csvPath.empty()) {
+            std::ofstream csv(options.csvPath, std::ios::trunc);
+            if (!csv) {
+                std::cerr << "No se pudo escribir " << options.csvPath << std::endl;
+                return 1;
+            }
+            csv << "frame,cpu_ms,frame_ms,gpu_ms,draw_calls,triangles\n";
+            for (uint32_t i = 0; i < samples.size(); ++i) {
+                const FrameSample& s = samples[i];
+                csv << i << ',' << s.cpuMilliseconds << ',' << s.frameMilliseconds << ',' << s.gpuMilliseconds
+                    << ',' << s.drawCalls << ',' << s.triangles << '\n';
+            }
+        }
+        return 0;
+    }
+}
+
+bool Headless::requested(int argc, char** argv) noexcept {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+int Headless::run(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+#ifdef MULTIVERSO_HEADLESS
+    EglContext context;
+    if (!context.create()) return 1;
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(&EglContext::procAddress))) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return 1;
+    }
+    std::cout << "OpenGL version: " << glGetString(GL_VERSION) << " (" << glGetString(GL_RENDERER) << ")" << std::endl;
+
+    return runFrames(options);
+#else
+    (void)runFrames;
+    std::cerr << "Compilado sin MULTIVERSO_HEADLESS: el modo --headless necesita EGL" << std::endl;
+    return 1;
+#endif
+}
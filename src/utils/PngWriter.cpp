@@ -0,0 +1,111 @@
+#include "utils/PngWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <vector>
+
+namespace {
+    // Bloque máximo de deflate sin comprimir (LEN de 16 bits)
+    constexpr uint32_t STORED_BLOCK = 65535;
+
+    const std::array<uint32_t, 256>& crcTable() {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length) noexcept {
+        const auto& table = crcTable();
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Longitud, tipo, datos y CRC del tipo + datos
+    void writeChunk(std::ofstream& out, const char type[4], const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(data.size() + 12);
+        appendU32(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        appendU32(chunk, crc32(0, chunk.data() + 4, data.size() + 4));
+        out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+}
+
+bool PngWriter::write(const std::string& path, uint32_t width, uint32_t height,
+                      const uint8_t* rgba, bool flipVertically) {
+    if (width == 0 || height == 0 || !rgba) return false;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    // IHDR: 8 bits por canal, RGBA (tipo 6), sin entrelazado
+    std::vector<uint8_t> header;
+    appendU32(header, width);
+    appendU32(header, height);
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+    writeChunk(out, "IHDR", header);
+
+    // Filas con filtro 0 (ninguno) delante
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint32_t row = flipVertically ? height - 1 - y : y;
+        const uint8_t* src = rgba + static_cast<size_t>(row) * rowBytes;
+        raw.push_back(0);
+        raw.insert(raw.end(), src, src + rowBytes);
+    }
+
+    // IDAT: flujo zlib con bloques deflate sin comprimir y Adler-32 al final
+    std::vector<uint8_t> idat;
+    idat.reserve(raw.size() + raw.size() / STORED_BLOCK * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    size_t offset = 0;
+    do {
+        const uint32_t length = static_cast<uint32_t>(std::min<size_t>(STORED_BLOCK, raw.size() - offset));
+        const bool last = offset + length == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<uint8_t>(length));
+        idat.push_back(static_cast<uint8_t>(length >> 8));
+        idat.push_back(static_cast<uint8_t>(~length));
+        idat.push_back(static_cast<uint8_t>(~length >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendU32(idat, (b << 16) | a);
+    writeChunk(out, "IDAT", idat);
+    writeChunk(out, "IEND", {});
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,78 @@
+#include "utils/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint32_t Profiler::phase(std::string_view name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint32_t i = 0; i < _names.size(); ++i) {
+        if (_names[i] == name) return i;
+    }
+    if (_names.size() == MAX_PHASES) return INVALID_PHASE;
+    _names.emplace_back(name);
+    return static_cast<uint32_t>(_names.size() - 1);
+}
+
+void Profiler::setEnabled(bool enabled) noexcept {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (enabled == _enabled.load(std::memory_order_relaxed)) return;
+    _enabled.store(enabled, std::memory_order_relaxed);
+
+    // El historial de una sesión anterior no es comparable
+    if (enabled) {
+        _current.fill(0.0);
+        _head = 0;
+        _frames = 0;
+    }
+}
+
+void Profiler::record(uint32_t phase, double milliseconds) noexcept {
+    if (!enabled() || phase >= MAX_PHASES) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _current[phase] += milliseconds;
+}
+
+void Profiler::endFrame() noexcept {
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint32_t i = 0; i < _names.size(); ++i) {
+        _history[i][_head] = static_cast<float>(_current[i]);
+        _current[i] = 0.0;
+    }
+    _head = (_head + 1) % HISTORY;
+    _frames = std::min(_frames + 1, HISTORY);
+}
+
+float Profiler::last(uint32_t phase) const noexcept {
+    if (_frames == 0) return 0.0f;
+    return _history[phase][(_head + HISTORY - 1) % HISTORY];
+}
+
+float Profiler::percentile(uint32_t phase, float p) const noexcept {
+    if (_frames == 0) return 0.0f;
+
+    // Copia en pila: la GUI lo llama cada frame sin reservar memoria
+    std::array<float, HISTORY> values;
+    std::copy_n(_history[phase].begin(), _frames, values.begin());
+    const uint32_t rank = std::min(_frames - 1, static_cast<uint32_t>(std::lround(p * (_frames - 1))));
+    std::nth_element(values.begin(), values.begin() + rank, values.begin() + _frames);
+    return values[rank];
+}
+
+// ----- Scope -----
+
+Profiler::Scope::Scope(uint32_t phase) noexcept
+    : _phase(phase), _active(Profiler::instance().enabled()) {
+    if (_active) _start = Clock::now();
+}
+
+Profiler::Scope::~Scope() {
+    if (_active) {
+        Profiler::instance().record(_phase, std::chrono::duration<double, std::milli>(Clock::now() - _start).count());
+    }
+}
@@ -0,0 +1,109 @@
+#include "utils/ThreadPool.hpp"
+#include "utils/Trace.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+    // Marca los hilos del pool para ejecutar en serie los parallelFor anidados
+    thread_local bool insidePool = false;
+}
+
+ThreadPool::ThreadPool(uint32_t workers) {
+    if (workers == 0) {
+        uint32_t hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 0;
+    }
+
+    _workers.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::run(uint32_t count, uint32_t grain, void* context, Task task) {
+    if (count == 0) return;
+    grain = std::max(1u, grain);
+
+    // Sin trabajadores, trabajo pequeño, llamada anidada u otro hilo despachando: en serie
+    if (_workers.empty() || count <= grain || insidePool || !_dispatchMutex.try_lock()) {
+        for (uint32_t begin = 0; begin < count; begin += grain) {
+            task(context, 0, begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = task;
+        _context = context;
+        _count = count;
+        _grain = grain;
+        _next.store(0, std::memory_order_relaxed);
+        _active = static_cast<uint32_t>(_workers.size());
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    insidePool = true;
+    drain(0);
+    insidePool = false;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _active == 0; });
+        _task = nullptr;
+    }
+    _dispatchMutex.unlock();
+}
+
+void ThreadPool::workerLoop(uint32_t index) {
+    insidePool = true;
+    if constexpr (Trace::COMPILED) {
+        Trace::setThreadName("Pool " + std::to_string(index));
+    }
+    uint64_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stop || _generation != seen; });
+            if (_stop) return;
+            seen = _generation;
+        }
+
+        drain(index);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_active == 0) {
+                _done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::drain(uint32_t worker) {
+    MULTIVERSO_TRACE_SCOPE("pool", "parallelFor");
+    while (true) {
+        uint32_t begin = _next.fetch_add(_grain, std::memory_order_relaxed);
+        if (begin >= _count) break;
+        _task(_context, worker, begin, std::min(_count, begin + _grain));
+    }
+}
@@ -0,0 +1,219 @@
+#include "utils/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point traceEpoch = Clock::now();
+
+    // Scope cerrado. Los campos son atómicos para que write() pueda leer un
+    // hueco mientras el dueño lo sobrescribe: `sequence` (índice + 1, 0
+    // mientras se escribe) se comprueba antes y después de copiarlo
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> category{nullptr};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};         // Nanosegundos desde traceEpoch
+        std::atomic<uint64_t> duration{0};
+    };
+
+    struct OpenScope {
+        const char* category;
+        const char* name;
+        uint64_t start;
+    };
+
+    // Solo el hilo dueño escribe; `head` (scopes cerrados desde el inicio)
+    // se publica con release y el anillo guarda los últimos CAPACITY
+    struct ThreadBuffer {
+        std::unique_ptr<Slot[]> slots{new Slot[Trace::CAPACITY]};
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> floor{0};         // Primer índice exportable (clear)
+        std::atomic<uint64_t> tooDeep{0};
+        OpenScope open[Trace::MAX_DEPTH];       // Solo el dueño
+        uint32_t depth = 0;
+        uint32_t tid = 0;
+        std::string name;           // Protegido por el mutex del registro
+    };
+
+    // Los buffers viven hasta el final del proceso: un hilo que termina deja
+    // sus eventos para la exportación. Se reserva con new para que los hilos
+    // del pool puedan seguir grabando durante la destrucción de estáticos.
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    };
+
+    Registry& registry() {
+        static Registry* instance = new Registry;
+        return *instance;
+    }
+
+    thread_local ThreadBuffer* localBuffer = nullptr;
+
+    ThreadBuffer& threadBuffer() {
+        if (!localBuffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+            localBuffer = reg.buffers.back().get();
+            localBuffer->tid = static_cast<uint32_t>(reg.buffers.size());
+        }
+        return *localBuffer;
+    }
+
+    uint64_t now() noexcept {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - traceEpoch).count());
+    }
+
+    void commit(ThreadBuffer& buffer, const OpenScope& scope, uint64_t end) noexcept {
+        const uint64_t index = buffer.head.load(std::memory_order_relaxed);
+        Slot& slot = buffer.slots[index % Trace::CAPACITY];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.category.store(scope.category, std::memory_order_relaxed);
+        slot.name.store(scope.name, std::memory_order_relaxed);
+        slot.start.store(scope.start, std::memory_order_relaxed);
+        slot.duration.store(end - scope.start, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+        buffer.head.store(index + 1, std::memory_order_release);
+    }
+
+    // Scopes conservados de los `head` cerrados (desde el último clear(), como mucho CAPACITY)
+    uint64_t retained(const ThreadBuffer& buffer, uint64_t head) noexcept {
+        const uint64_t floor = std::min(head, buffer.floor.load(std::memory_order_relaxed));
+        return std::min<uint64_t>(head - floor, Trace::CAPACITY);
+    }
+
+    uint64_t overwritten(const ThreadBuffer& buffer, uint64_t head) noexcept {
+        return head - std::min(head, buffer.floor.load(std::memory_order_relaxed)) - retained(buffer, head);
+    }
+
+    bool startEnabled() noexcept {
+        const char* value = std::getenv("MULTIVERSO_TRACE");
+        return value && std::strcmp(value, "0") != 0;
+    }
+
+    void writeEscaped(std::ofstream& out, const char* text) {
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+    }
+}
+
+std::atomic<bool> Trace::_enabled{startEnabled()};
+
+void Trace::setEnabled(bool enabled) {
+    const bool wasEnabled = _enabled.exchange(enabled, std::memory_order_relaxed);
+    if (enabled && !wasEnabled) clear();
+}
+
+void Trace::setThreadName(std::string_view name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name.assign(name);
+}
+
+bool Trace::begin(const char* category, const char* name) noexcept {
+    ThreadBuffer& buffer = threadBuffer();
+    if (buffer.depth >= MAX_DEPTH) {
+        buffer.tooDeep.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buffer.open[buffer.depth++] = {category, name, now()};
+    return true;
+}
+
+void Trace::end() noexcept {
+    ThreadBuffer& buffer = *localBuffer;
+    commit(buffer, buffer.open[--buffer.depth], now());
+}
+
+bool Trace::write(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Multiverso\"}}";
+
+    char timestamp[32];
+    char length[32];
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->name.empty()) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"";
+            writeEscaped(out, buffer->name.c_str());
+            out << "\"}}";
+        }
+
+        // Del anillo, los huecos que no se sobrescribieron mientras se leían
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t first = head - retained(*buffer, head);
+        for (uint64_t i = first; i < head; ++i) {
+            const Slot& slot = buffer->slots[i % CAPACITY];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != i + 1) continue;
+            const char* category = slot.category.load(std::memory_order_relaxed);
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            const uint64_t start = slot.start.load(std::memory_order_relaxed);
+            const uint64_t duration = slot.duration.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+            std::snprintf(timestamp, sizeof(timestamp), "%.3f", static_cast<double>(start) / 1000.0);
+            std::snprintf(length, sizeof(length), "%.3f", static_cast<double>(duration) / 1000.0);
+            out << ",\n{\"ph\":\"X\",\"ts\":" << timestamp << ",\"dur\":" << length
+                << ",\"pid\":1,\"tid\":" << buffer->tid << ",\"cat\":\"";
+            writeEscaped(out, category);
+            out << "\",\"name\":\"";
+            writeEscaped(out, name);
+            out << "\"}";
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+void Trace::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        buffer->floor.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        buffer->tooDeep.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Trace::eventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t total = 0;
+    for (const auto& buffer : reg.buffers) {
+        total += retained(*buffer, buffer->head.load(std::memory_order_acquire));
+    }
+    return total;
+}
+
+uint64_t Trace::dropped() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t total = 0;
+    for (const auto& buffer : reg.buffers) {
+        total += overwritten(*buffer, buffer->head.load(std::memory_order_acquire)) +
+                 buffer->tooDeep.load(std::memory_order_relaxed);
+    }
+    return total;
+}